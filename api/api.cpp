@@ -398,6 +398,19 @@ OIDN_API_NAMESPACE_BEGIN
     return reinterpret_cast<OIDNDevice>(device.detach());
   }
 
+  OIDN_API OIDNDevice oidnNewCPUDevice(OIDNParallelForFunction func, void* userPtr)
+  {
+    Ref<Device> device = nullptr;
+    OIDN_TRY
+      if (func == nullptr)
+        throw Exception(Error::InvalidArgument, "parallel for function is null");
+      Context& ctx = initContext();
+      auto factory = static_cast<CPUDeviceFactoryBase*>(ctx.getDeviceFactory(DeviceType::CPU));
+      device = factory->newDevice(func, userPtr);
+    OIDN_CATCH
+    return reinterpret_cast<OIDNDevice>(device.detach());
+  }
+
   OIDN_API void oidnRetainDevice(OIDNDevice hDevice)
   {
     Device* device = reinterpret_cast<Device*>(hDevice);
@@ -456,6 +469,30 @@ OIDN_API_NAMESPACE_BEGIN
     return 0;
   }
 
+  OIDN_API void oidnSetDeviceString(OIDNDevice hDevice, const char* name, const char* value)
+  {
+    Device* device = reinterpret_cast<Device*>(hDevice);
+    OIDN_TRY
+      checkHandle(hDevice);
+      OIDN_LOCK_DEVICE(device);
+      checkString(name);
+      checkString(value);
+      device->setString(name, value);
+    OIDN_CATCH_DEVICE(device)
+  }
+
+  OIDN_API const char* oidnGetDeviceString(OIDNDevice hDevice, const char* name)
+  {
+    Device* device = reinterpret_cast<Device*>(hDevice);
+    OIDN_TRY
+      checkHandle(hDevice);
+      OIDN_LOCK_DEVICE(device);
+      checkString(name);
+      return device->getString(name);
+    OIDN_CATCH_DEVICE(device)
+    return nullptr;
+  }
+
   OIDN_API void oidnSetDeviceErrorFunction(OIDNDevice hDevice, OIDNErrorFunction func, void* userPtr)
   {
     Device* device = reinterpret_cast<Device*>(hDevice);
@@ -790,6 +827,21 @@ OIDN_API_NAMESPACE_BEGIN
     OIDN_CATCH_DEVICE(filter)
   }
 
+  OIDN_API const void* oidnGetFilterData(OIDNFilter hFilter, const char* name, size_t* byteSize)
+  {
+    Filter* filter = reinterpret_cast<Filter*>(hFilter);
+    OIDN_TRY
+      checkHandle(hFilter);
+      OIDN_LOCK_DEVICE(filter);
+      checkString(name);
+      Data data = filter->getData(name);
+      if (byteSize != nullptr)
+        *byteSize = data.size;
+      return data.ptr;
+    OIDN_CATCH_DEVICE(filter)
+    return nullptr;
+  }
+
   OIDN_API void oidnSetFilterBool(OIDNFilter hFilter, const char* name, bool value)
   {
     Filter* filter = reinterpret_cast<Filter*>(hFilter);
@@ -859,6 +911,30 @@ OIDN_API_NAMESPACE_BEGIN
     return 0;
   }
 
+  OIDN_API void oidnSetFilterString(OIDNFilter hFilter, const char* name, const char* value)
+  {
+    Filter* filter = reinterpret_cast<Filter*>(hFilter);
+    OIDN_TRY
+      checkHandle(hFilter);
+      OIDN_LOCK_DEVICE(filter);
+      checkString(name);
+      checkString(value);
+      filter->setString(name, value);
+    OIDN_CATCH_DEVICE(filter)
+  }
+
+  OIDN_API const char* oidnGetFilterString(OIDNFilter hFilter, const char* name)
+  {
+    Filter* filter = reinterpret_cast<Filter*>(hFilter);
+    OIDN_TRY
+      checkHandle(hFilter);
+      OIDN_LOCK_DEVICE(filter);
+      checkString(name);
+      return filter->getString(name);
+    OIDN_CATCH_DEVICE(filter)
+    return nullptr;
+  }
+
   OIDN_API void oidnSetFilterProgressMonitorFunction(OIDNFilter hFilter,
                                                      OIDNProgressMonitorFunction func, void* userPtr)
   {
@@ -7,7 +7,6 @@
 #include "utils/image_io.h"
 #include "utils/device_info.h"
 #include <iostream>
-#include <fstream>
 #include <iomanip>
 #include <cassert>
 #include <limits>
@@ -30,7 +29,7 @@ void printUsage()
             << "                   [-o/--output output.pfm]" << std::endl
             << "                   [-r/--ref reference_output.pfm] [--maxerror e]" << std::endl
             << "                   [-t/--type float|half]" << std::endl
-            << "                   [-q/--quality default|h|high|b|balanced]" << std::endl
+            << "                   [-q/--quality default|h|high|b|balanced|f|fast]" << std::endl
             << "                   [-w/--weights weights.tza]" << std::endl
             << "                   [--threads n] [--affinity 0|1] [--maxmem MB] [--inplace]" << std::endl
             << "                   [--buffer host|device|managed]" << std::endl
@@ -61,21 +60,6 @@ bool progressCallback(void* userPtr, double n)
   return true;
 }
 
-std::vector<char> loadFile(const std::string& filename)
-{
-  std::ifstream file(filename, std::ios::binary);
-  if (file.fail())
-    throw std::runtime_error("cannot open file: '" + filename + "'");
-  file.seekg(0, file.end);
-  const size_t size = file.tellg();
-  file.seekg(0, file.beg);
-  std::vector<char> buffer(size);
-  file.read(buffer.data(), size);
-  if (file.fail())
-    throw std::runtime_error("error reading from file: '" + filename + "'");
-  return buffer;
-}
-
 int main(int argc, char* argv[])
 {
   DeviceType deviceType = DeviceType::Default;
@@ -171,6 +155,8 @@ int main(int argc, char* argv[])
           quality = Quality::High;
         else if (val == "b" || val == "balanced")
           quality = Quality::Balanced;
+        else if (val == "f" || val == "fast")
+          quality = Quality::Fast;
         else
           throw std::runtime_error("invalid filter quality mode");
       }
@@ -315,14 +301,6 @@ int main(int argc, char* argv[])
     if (inplace && numRuns > 1)
       inputCopy = input->clone();
 
-    // Load the filter weights if specified
-    std::vector<char> weights;
-    if (!weightsFilename.empty())
-    {
-      std::cout << "Loading filter weights" << std::endl;
-      weights = loadFile(weightsFilename);
-    }
-
     // Initialize the denoising filter
     std::cout << "Initializing filter" << std::endl;
     timer.reset();
@@ -363,8 +341,9 @@ int main(int argc, char* argv[])
     if (maxMemoryMB >= 0)
       filter.set("maxMemoryMB", maxMemoryMB);
 
-    if (!weights.empty())
-      filter.setData("weights", weights.data(), weights.size());
+    // The weights file is mapped into memory by the filter
+    if (!weightsFilename.empty())
+      filter.set("weightsPath", weightsFilename);
 
     const bool showProgress = verbose <= 1;
     if (showProgress)
@@ -7,6 +7,10 @@
 #include <cassert>
 #include <cmath>
 #include <limits>
+#include <thread>
+#include <atomic>
+#include <fstream>
+#include <functional>
 
 #define CATCH_CONFIG_RUNNER
 #define CATCH_CONFIG_FAST_COMPILE
@@ -317,6 +321,58 @@ bool isBetween(const std::shared_ptr<ImageBuffer>& image, float a, float b)
   return true;
 }
 
+// Returns the directory for temporary files
+std::string getTempDir()
+{
+#if defined(_WIN32)
+  const char* tempDir = getenv("TEMP");
+  return tempDir ? tempDir : ".";
+#else
+  const char* tempDir = getenv("TMPDIR");
+  return tempDir ? tempDir : "/tmp";
+#endif
+}
+
+// Filters the same random image on a reference device and on another device (which may be the same
+// device), and requires the outputs to match
+// The setup function is called for both filters before committing them, with isRef set for the
+// reference filter
+void runAndCompare(DeviceRef& refDevice, DeviceRef& device, int W, int H,
+                   const std::function<void(FilterRef& filter, bool isRef)>& setup = nullptr,
+                   double errorThreshold = 0.005)
+{
+  auto input = makeImage(refDevice, W, H);
+  Random rng;
+  for (size_t i = 0; i < input->getSize(); ++i)
+    input->set(i, rng.getFloat());
+
+  auto runFilter = [&](DeviceRef& curDevice, bool isRef)
+  {
+    FilterRef filter = curDevice.newFilter("RT");
+    REQUIRE(bool(filter));
+
+    auto output = makeImage(curDevice, W, H);
+    setFilterImage(filter, "color",  input, false);
+    setFilterImage(filter, "output", output);
+    if (setup)
+      setup(filter, isRef);
+    filter.commit();
+    REQUIRE(curDevice.getError() == Error::None);
+
+    filter.execute();
+    REQUIRE(curDevice.getError() == Error::None);
+    return output;
+  };
+
+  auto refOutput = runFilter(refDevice, true);
+  auto output    = runFilter(device, false);
+
+  size_t numErrors;
+  double avgError;
+  std::tie(numErrors, avgError) = compareImage(*output, *refOutput, errorThreshold);
+  REQUIRE(numErrors == 0);
+}
+
 // -------------------------------------------------------------------------------------------------
 
 TEST_CASE("single filter", "[single_filter][minimal]")
@@ -506,61 +562,857 @@ TEST_CASE("multiple filters", "[multi_filter]")
     multiFilter1PerDeviceTest(device, {257, 257, 3001, 1024}, true);
   }
 
-  SECTION("3 filters / device: small")
-  {
-    multiFilterNPerDeviceTest(device, {256, 256, 256});
-  }
+  SECTION("3 filters / device: small")
+  {
+    multiFilterNPerDeviceTest(device, {256, 256, 256});
+  }
+
+  SECTION("2 filters / device: small -> large")
+  {
+    multiFilterNPerDeviceTest(device, {256, 3001});
+  }
+
+  SECTION("3 filters / device: large -> small -> medium")
+  {
+    multiFilterNPerDeviceTest(device, {3001, 257, 1024});
+  }
+
+  SECTION("3 filters / device: small -> medium -> large")
+  {
+    multiFilterNPerDeviceTest(device, {400, 1100, 3000});
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TEST_CASE("multiple devices", "[multi_device]")
+{
+  const std::vector<int> sizes = {111, 256, 80};
+
+  std::vector<DeviceRef> devices;
+  std::vector<FilterRef> filters;
+  std::vector<std::shared_ptr<ImageBuffer>> images;
+
+  for (size_t i = 0; i < sizes.size(); ++i)
+  {
+    devices.push_back(makeAndCommitDevice());
+
+    filters.push_back(devices[i].newFilter("RT"));
+    REQUIRE(bool(filters[i]));
+
+    images.push_back(makeConstImage(devices[i], sizes[i], sizes[i], 3, DataType::Float16, 0.5f));
+    setFilterImage(filters[i], "color",  images[i]);
+    setFilterImage(filters[i], "output", images[i]);
+
+    filters[i].set("hdr", true);
+    filters[i].commit();
+    REQUIRE(devices[i].getError() == Error::None);
+  }
+
+  for (size_t i = 0; i < devices.size(); ++i)
+  {
+    filters[i].execute();
+    REQUIRE(devices[i].getError() == Error::None);
+    REQUIRE(isBetween(images[i], 0.1f, 1.0f)); // output sanity check
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TEST_CASE("concurrent tiles", "[concurrent_tiles]")
+{
+  const int W = 1920;
+  const int H = 1080;
+
+  DeviceRef refDevice = makeDevice();
+  if (refDevice.get<DeviceType>("type") != DeviceType::CPU)
+    return; // supported only by CPU devices
+  refDevice.set("maxConcurrentTiles", 1);
+  refDevice.commit();
+  REQUIRE(refDevice.getError() == Error::None);
+
+  DeviceRef device = makeDevice();
+  device.set("maxConcurrentTiles", 2);
+  device.commit();
+  REQUIRE(device.getError() == Error::None);
+  REQUIRE(device.get<int>("maxConcurrentTiles") == 2);
+
+  auto input = makeImage(device, W, H);
+  Random rng;
+  for (size_t i = 0; i < input->getSize(); ++i)
+    input->set(i, rng.getFloat());
+
+  auto runFilter = [&](DeviceRef& curDevice)
+  {
+    FilterRef filter = curDevice.newFilter("RT");
+    REQUIRE(bool(filter));
+
+    auto output = makeImage(curDevice, W, H);
+    setFilterImage(filter, "color",  input, false);
+    setFilterImage(filter, "output", output);
+    filter.commit();
+    REQUIRE(curDevice.getError() == Error::None);
+
+    filter.execute();
+    REQUIRE(curDevice.getError() == Error::None);
+    return output;
+  };
+
+  auto refOutput = runFilter(refDevice);
+  auto output    = runFilter(device);
+
+  size_t numErrors;
+  double avgError;
+  std::tie(numErrors, avgError) = compareImage(*output, *refOutput);
+  REQUIRE(numErrors == 0);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TEST_CASE("batch", "[batch]")
+{
+  const int W = 211;
+  const int H = 97;
+  const int batchSize = 3;
+
+  DeviceRef device = makeDevice();
+  device.commit();
+  REQUIRE(device.getError() == Error::None);
+
+  // Stack images with different exposures
+  auto input  = makeImage(device, W, H * batchSize);
+  auto output = makeImage(device, W, H * batchSize);
+  const size_t imageSize = input->getSize() / batchSize;
+  Random rng;
+  for (size_t i = 0; i < input->getSize(); ++i)
+    input->set(i, rng.getFloat() * float(1 << (3 * (i / imageSize))));
+
+  FilterRef filter = device.newFilter("RT");
+  REQUIRE(bool(filter));
+
+  SECTION("invalid batch size")
+  {
+    setFilterImage(filter, "color",  input);
+    setFilterImage(filter, "output", output);
+    filter.set("batchSize", 2);
+    filter.commit();
+    REQUIRE(device.getError() == Error::InvalidOperation);
+  }
+
+  // Compares the output of each image in the batch to denoising it separately
+  auto checkSeparateImages = [&](bool hdr)
+  {
+    for (int b = 0; b < batchSize; ++b)
+    {
+      auto refInput  = makeImage(device, W, H);
+      auto refOutput = makeImage(device, W, H);
+      auto batchOutput = makeImage(device, W, H);
+      for (size_t i = 0; i < imageSize; ++i)
+      {
+        refInput->set(i, input->get(b * imageSize + i));
+        batchOutput->set(i, output->get(b * imageSize + i));
+      }
+
+      FilterRef refFilter = device.newFilter("RT");
+      setFilterImage(refFilter, "color",  refInput);
+      setFilterImage(refFilter, "output", refOutput);
+      refFilter.set("hdr", hdr);
+      refFilter.commit();
+      refFilter.execute();
+      REQUIRE(device.getError() == Error::None);
+
+      size_t numErrors;
+      double avgError;
+      std::tie(numErrors, avgError) = compareImage(*batchOutput, *refOutput);
+      REQUIRE(numErrors == 0);
+    }
+  };
+
+  SECTION("batch vs separate images")
+  {
+    setFilterImage(filter, "color",  input);
+    setFilterImage(filter, "output", output);
+    filter.set("hdr", true);
+    filter.set("batchSize", batchSize);
+    filter.commit();
+    REQUIRE(device.getError() == Error::None);
+    REQUIRE(filter.get<int>("batchSize") == batchSize);
+
+    filter.execute();
+    REQUIRE(device.getError() == Error::None);
+    checkSeparateImages(true);
+  }
+
+  SECTION("packed images")
+  {
+    // Images with the same input scale are packed into the same tile
+    for (size_t i = 0; i < input->getSize(); ++i)
+      input->set(i, rng.getFloat());
+
+    setFilterImage(filter, "color",  input);
+    setFilterImage(filter, "output", output);
+    filter.set("batchSize", batchSize);
+    filter.commit();
+    REQUIRE(device.getError() == Error::None);
+    REQUIRE(filter.get<int>("tileCountX") == 1);
+    REQUIRE(filter.get<int>("tileCountY") == 1);
+
+    filter.execute();
+    REQUIRE(device.getError() == Error::None);
+    checkSeparateImages(false);
+  }
+
+  SECTION("packed images switched to automatic exposure")
+  {
+    setFilterImage(filter, "color",  input);
+    setFilterImage(filter, "output", output);
+    filter.set("hdr", true);
+    filter.set("inputScale", 1.f);
+    filter.set("batchSize", batchSize);
+    filter.commit();
+    filter.execute();
+    REQUIRE(device.getError() == Error::None);
+
+    // Computing the input scale of each image must not use the packed tiles anymore
+    filter.set("inputScale", std::numeric_limits<float>::quiet_NaN());
+    filter.commit();
+    filter.execute();
+    REQUIRE(device.getError() == Error::None);
+    checkSeparateImages(true);
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TEST_CASE("pipelined tiles", "[pipelined_tiles]")
+{
+  const int W = 1600;
+  const int H = 900;
+  const int batchSize = 2;
+
+  DeviceRef device = makeDevice();
+  device.commit();
+  REQUIRE(device.getError() == Error::None);
+
+  // Stack images with different exposures, so the tiles of adjacent images have different scales
+  auto input  = makeImage(device, W, H * batchSize);
+  auto output = makeImage(device, W, H * batchSize);
+  const size_t imageSize = input->getSize() / batchSize;
+  Random rng;
+  for (size_t i = 0; i < input->getSize(); ++i)
+    input->set(i, rng.getFloat() * float(1 << (3 * (i / imageSize))));
+
+  // Denoise the batch with multiple tiles per image (pipelined on devices which support it)
+  FilterRef filter = device.newFilter("RT");
+  REQUIRE(bool(filter));
+  setFilterImage(filter, "color",  input);
+  setFilterImage(filter, "output", output);
+  filter.set("hdr", true);
+  filter.set("batchSize", batchSize);
+  filter.set("maxMemoryMB", 0); // make sure there will be multiple tiles
+  filter.commit();
+  REQUIRE(device.getError() == Error::None);
+
+  filter.execute();
+  REQUIRE(device.getError() == Error::None);
+
+  for (int b = 0; b < batchSize; ++b)
+  {
+    auto refInput  = makeImage(device, W, H);
+    auto refOutput = makeImage(device, W, H);
+    auto batchOutput = makeImage(device, W, H);
+    for (size_t i = 0; i < imageSize; ++i)
+    {
+      refInput->set(i, input->get(b * imageSize + i));
+      batchOutput->set(i, output->get(b * imageSize + i));
+    }
+
+    FilterRef refFilter = device.newFilter("RT");
+    setFilterImage(refFilter, "color",  refInput);
+    setFilterImage(refFilter, "output", refOutput);
+    refFilter.set("hdr", true);
+    refFilter.commit();
+    refFilter.execute();
+    REQUIRE(device.getError() == Error::None);
+
+    size_t numErrors;
+    double avgError;
+    std::tie(numErrors, avgError) = compareImage(*batchOutput, *refOutput);
+    REQUIRE(numErrors == 0);
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TEST_CASE("in-place tiles", "[inplace_tiles]")
+{
+  const int W = 1600;
+  const int H = 1300;
+
+  DeviceRef device = makeDevice();
+  device.commit();
+  REQUIRE(device.getError() == Error::None);
+
+  auto input = makeImage(device, W, H);
+  Random rng;
+  for (size_t i = 0; i < input->getSize(); ++i)
+    input->set(i, rng.getFloat());
+
+  // The rows of tiles overlap, so the output of a row must not overwrite the input of the next one
+  auto runFilter = [&](bool inplace, bool roi)
+  {
+    auto image  = makeImage(device, W, H);
+    auto output = inplace ? image : makeImage(device, W, H);
+    for (size_t i = 0; i < input->getSize(); ++i)
+    {
+      image->set(i, input->get(i));
+      output->set(i, input->get(i));
+    }
+
+    FilterRef filter = device.newFilter("RT");
+    REQUIRE(bool(filter));
+    setFilterImage(filter, "color",  image);
+    setFilterImage(filter, "output", output);
+    filter.set("maxMemoryMB", 0); // make sure there will be multiple tiles
+    if (roi)
+    {
+      filter.set("roiX", 211);
+      filter.set("roiY", 213);
+      filter.set("roiW", 1201);
+      filter.set("roiH", 887);
+    }
+    filter.commit();
+    REQUIRE(device.getError() == Error::None);
+    REQUIRE(filter.get<int>("tileCountY") > 1);
+
+    filter.execute();
+    REQUIRE(device.getError() == Error::None);
+    return output;
+  };
+
+  SECTION("in-place tiles: whole image")
+  {
+    auto refOutput = runFilter(false, false);
+    auto output    = runFilter(true,  false);
+
+    size_t numErrors;
+    double avgError;
+    std::tie(numErrors, avgError) = compareImage(*output, *refOutput);
+    REQUIRE(numErrors == 0);
+  }
+
+  SECTION("in-place tiles: region of interest")
+  {
+    auto refOutput = runFilter(false, true);
+    auto output    = runFilter(true,  true);
+
+    size_t numErrors;
+    double avgError;
+    std::tie(numErrors, avgError) = compareImage(*output, *refOutput);
+    REQUIRE(numErrors == 0);
+  }
+
+  SECTION("in-place tiles: resized region of interest")
+  {
+    // The region of interest is clamped to the right edge of the image by the tile overlap, so
+    // changing its width does not change the processed region and the filter is not reinitialized
+    const int roiX = W - 250;
+
+    auto image = makeImage(device, W, H);
+    FilterRef filter = device.newFilter("RT");
+    REQUIRE(bool(filter));
+    setFilterImage(filter, "color",  image);
+    setFilterImage(filter, "output", image);
+    filter.set("maxMemoryMB", 0);
+    filter.set("roiX", roiX);
+    filter.set("roiY", 213);
+    filter.set("roiH", 887);
+
+    for (int roiW : {200, 250, 200})
+    {
+      for (size_t i = 0; i < input->getSize(); ++i)
+        image->set(i, input->get(i));
+
+      filter.set("roiW", roiW);
+      filter.commit();
+      REQUIRE(device.getError() == Error::None);
+      REQUIRE(filter.get<int>("tileCountY") > 1);
+
+      filter.execute();
+      REQUIRE(device.getError() == Error::None);
+
+      auto refOutput = makeImage(device, W, H);
+      for (size_t i = 0; i < input->getSize(); ++i)
+        refOutput->set(i, input->get(i));
+
+      FilterRef refFilter = device.newFilter("RT");
+      setFilterImage(refFilter, "color",  input);
+      setFilterImage(refFilter, "output", refOutput);
+      refFilter.set("maxMemoryMB", 0);
+      refFilter.set("roiX", roiX);
+      refFilter.set("roiY", 213);
+      refFilter.set("roiW", roiW);
+      refFilter.set("roiH", 887);
+      refFilter.commit();
+      refFilter.execute();
+      REQUIRE(device.getError() == Error::None);
+
+      size_t numErrors;
+      double avgError;
+      std::tie(numErrors, avgError) = compareImage(*image, *refOutput);
+      REQUIRE(numErrors == 0);
+    }
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TEST_CASE("memory usage estimation", "[memory_usage]")
+{
+  const int W = 1920;
+  const int H = 1080;
+
+  DeviceRef device = makeDevice();
+  device.commit();
+  REQUIRE(device.getError() == Error::None);
+
+  FilterRef filter = device.newFilter("RT");
+  REQUIRE(bool(filter));
+
+  auto input  = makeImage(device, W, H);
+  auto output = makeImage(device, W, H);
+  setFilterImage(filter, "color",  input);
+  setFilterImage(filter, "albedo", input);
+  setFilterImage(filter, "output", output);
+
+  auto getStats = [&]()
+  {
+    std::vector<int> stats = {filter.get<int>("memoryUsageMB"),
+                              filter.get<int>("scratchMB"),
+                              filter.get<int>("weightsMB"),
+                              filter.get<int>("tileCountX"),
+                              filter.get<int>("tileCountY"),
+                              filter.get<int>("tileWidth"),
+                              filter.get<int>("tileHeight")};
+    REQUIRE(device.getError() == Error::None);
+    return stats;
+  };
+
+  SECTION("estimate before commit")
+  {
+    const auto estimatedStats = getStats();
+    REQUIRE(estimatedStats[0] > 0);
+    REQUIRE(estimatedStats[0] >= estimatedStats[1] + estimatedStats[2] - 1);
+
+    // The filter cannot be executed without committing
+    filter.execute();
+    REQUIRE(device.getError() == Error::InvalidOperation);
+
+    filter.commit();
+    REQUIRE(device.getError() == Error::None);
+    REQUIRE(getStats() == estimatedStats);
+
+    filter.execute();
+    REQUIRE(device.getError() == Error::None);
+  }
+
+  SECTION("estimate with memory limit")
+  {
+    filter.commit();
+    REQUIRE(device.getError() == Error::None);
+    const auto stats = getStats();
+
+    filter.set("maxMemoryMB", 100);
+    const auto limitedStats = getStats();
+    REQUIRE(limitedStats[3] * limitedStats[4] > stats[3] * stats[4]);
+    REQUIRE(limitedStats[1] < stats[1]);
+
+    filter.commit();
+    REQUIRE(device.getError() == Error::None);
+    REQUIRE(getStats() == limitedStats);
+  }
+
+  SECTION("estimate with resized region of interest")
+  {
+    filter.commit();
+    REQUIRE(device.getError() == Error::None);
+    const auto stats = getStats();
+
+    // Resizing the region of interest requires a new estimate even though no other parameter changed
+    filter.set("roiX", 0);
+    filter.set("roiY", 0);
+    filter.set("roiW", 256);
+    filter.set("roiH", 256);
+    const auto roiStats = getStats();
+    REQUIRE(roiStats[1] < stats[1]);
+
+    filter.commit();
+    REQUIRE(device.getError() == Error::None);
+    REQUIRE(getStats() == roiStats);
+  }
+
+  SECTION("estimate keeps the committed model")
+  {
+    filter.commit();
+    REQUIRE(device.getError() == Error::None);
+    const auto stats = getStats();
+    const int deviceMemoryUsageMB = device.get<int>("memoryUsageMB");
+    REQUIRE(deviceMemoryUsageMB > 0);
+
+    // Estimating for different parameters must not release the committed model
+    filter.set("maxMemoryMB", 100);
+    getStats();
+    REQUIRE(device.get<int>("memoryUsageMB") == deviceMemoryUsageMB);
+
+    filter.set("maxMemoryMB", -1);
+    filter.commit();
+    REQUIRE(device.getError() == Error::None);
+    REQUIRE(getStats() == stats);
+
+    filter.execute();
+    REQUIRE(device.getError() == Error::None);
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TEST_CASE("device memory budget", "[memory_usage]")
+{
+  const int W = 1920;
+  const int H = 1080;
+  const int maxMemoryMB = 500;
+
+  DeviceRef device = makeDevice();
+  device.set("maxMemoryMB", maxMemoryMB);
+  device.commit();
+  REQUIRE(device.getError() == Error::None);
+  REQUIRE(device.get<int>("maxMemoryMB") == maxMemoryMB);
+
+  auto input = makeImage(device, W, H);
+  Random rng;
+  for (size_t i = 0; i < input->getSize(); ++i)
+    input->set(i, rng.getFloat());
+
+  // Filters which are not executed at the same time share the scratch memory
+  std::vector<FilterRef> filters;
+  std::vector<std::shared_ptr<ImageBuffer>> outputs;
+  for (int i = 0; i < 4; ++i)
+  {
+    FilterRef filter = device.newFilter("RT");
+    REQUIRE(bool(filter));
+    auto output = makeImage(device, W, H);
+    setFilterImage(filter, "color",  input, false);
+    if (i % 2 == 1)
+      setFilterImage(filter, "albedo", input, false);
+    setFilterImage(filter, "output", output);
+    filter.commit();
+    REQUIRE(device.getError() == Error::None);
+    filters.push_back(filter);
+    outputs.push_back(output);
+  }
+
+  for (auto& filter : filters)
+  {
+    filter.execute();
+    REQUIRE(device.getError() == Error::None);
+  }
+
+  REQUIRE(device.get<int>("memoryUsageMB") > 0);
+  REQUIRE(device.get<int>("memoryUsageMB") <= maxMemoryMB);
+
+  // The output must not depend on the budget
+  DeviceRef refDevice = makeDevice();
+  refDevice.commit();
+  REQUIRE(refDevice.getError() == Error::None);
+
+  FilterRef refFilter = refDevice.newFilter("RT");
+  auto refOutput = makeImage(refDevice, W, H);
+  setFilterImage(refFilter, "color",  input, false);
+  setFilterImage(refFilter, "output", refOutput);
+  refFilter.commit();
+  refFilter.execute();
+  REQUIRE(refDevice.getError() == Error::None);
+
+  size_t numErrors;
+  double avgError;
+  std::tie(numErrors, avgError) = compareImage(*outputs[0], *refOutput);
+  REQUIRE(numErrors == 0);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TEST_CASE("region of interest", "[roi]")
+{
+  const int W = 913;
+  const int H = 577;
+  const int roiX = 301;
+  const int roiY = 117;
+  const int roiW = 155;
+  const int roiH = 98;
+
+  DeviceRef device = makeAndCommitDevice();
+
+  auto input     = makeImage(device, W, H);
+  auto refOutput = makeImage(device, W, H);
+  auto output    = makeImage(device, W, H);
+  Random rng;
+  for (size_t i = 0; i < input->getSize(); ++i)
+  {
+    input->set(i, rng.getFloat() * 4.f);
+    output->set(i, -1.f);
+  }
+
+  FilterRef refFilter = device.newFilter("RT");
+  REQUIRE(bool(refFilter));
+  setFilterImage(refFilter, "color",  input);
+  setFilterImage(refFilter, "output", refOutput);
+  refFilter.set("hdr", true);
+  refFilter.commit();
+  refFilter.execute();
+  REQUIRE(device.getError() == Error::None);
+
+  FilterRef filter = device.newFilter("RT");
+  REQUIRE(bool(filter));
+  setFilterImage(filter, "color",  input);
+  setFilterImage(filter, "output", output);
+  filter.set("hdr", true);
+
+  SECTION("out of bounds")
+  {
+    filter.set("roiX", W - roiW + 1);
+    filter.set("roiW", roiW);
+    filter.set("roiH", roiH);
+    filter.commit();
+    REQUIRE(device.getError() == Error::InvalidOperation);
+  }
+
+  // Checks that only the region of interest was written and it matches the full denoised image
+  auto checkOutput = [&](int x, int y)
+  {
+    auto regionOutput    = makeImage(device, roiW, roiH);
+    auto regionRefOutput = makeImage(device, roiW, roiH);
+    size_t numOutside = 0;
+
+    for (int h = 0; h < H; ++h)
+    {
+      for (int w = 0; w < W; ++w)
+      {
+        const bool inside = h >= y && h < y + roiH && w >= x && w < x + roiW;
+        for (int c = 0; c < 3; ++c)
+        {
+          const size_t i = (size_t(h) * W + w) * 3 + c;
+          if (inside)
+          {
+            const size_t j = (size_t(h - y) * roiW + (w - x)) * 3 + c;
+            regionOutput->set(j, output->get(i));
+            regionRefOutput->set(j, refOutput->get(i));
+          }
+          else if (output->get(i) != -1.f)
+            ++numOutside;
+        }
+      }
+    }
+
+    REQUIRE(numOutside == 0);
+
+    size_t numErrors;
+    double avgError;
+    std::tie(numErrors, avgError) = compareImage(*regionOutput, *regionRefOutput);
+    REQUIRE(numErrors == 0);
+  };
+
+  SECTION("region vs whole image")
+  {
+    filter.set("roiX", roiX);
+    filter.set("roiY", roiY);
+    filter.set("roiW", roiW);
+    filter.set("roiH", roiH);
+    filter.commit();
+    REQUIRE(device.getError() == Error::None);
+    REQUIRE(filter.get<int>("roiW") == roiW);
+
+    filter.execute();
+    REQUIRE(device.getError() == Error::None);
+    checkOutput(roiX, roiY);
+
+    // Move the region
+    for (size_t i = 0; i < output->getSize(); ++i)
+      output->set(i, -1.f);
+    filter.set("roiX", W - roiW);
+    filter.set("roiY", 0);
+    filter.commit();
+    filter.execute();
+    REQUIRE(device.getError() == Error::None);
+    checkOutput(W - roiW, 0);
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TEST_CASE("streaming", "[streaming]")
+{
+  const int W = 233;
+  const int H = 151;
+
+  DeviceRef device = makeAndCommitDevice();
+
+  auto color  = makeImage(device, W, H);
+  auto albedo = makeImage(device, W, H);
+  auto normal = makeImage(device, W, H);
+  auto output = makeImage(device, W, H);
+  Random rng;
+  for (size_t i = 0; i < color->getSize(); ++i)
+  {
+    color->set(i,  rng.getFloat() * 4.f);
+    albedo->set(i, rng.getFloat());
+    normal->set(i, rng.getFloat() * 2.f - 1.f);
+  }
+
+  FilterRef filter = device.newFilter("RT");
+  REQUIRE(bool(filter));
+  setFilterImage(filter, "color",  color);
+  setFilterImage(filter, "albedo", albedo);
+  setFilterImage(filter, "normal", normal);
+  setFilterImage(filter, "output", output);
+  filter.set("hdr", true);
+  filter.set("streaming", true);
+  filter.commit();
+  REQUIRE(device.getError() == Error::None);
+  REQUIRE(filter.get<bool>("streaming"));
+
+  filter.execute();
+  REQUIRE(device.getError() == Error::None);
+
+  // Denoises the current images from scratch with a non-streaming filter
+  auto checkOutput = [&]()
+  {
+    auto refOutput = makeImage(device, W, H);
+    FilterRef refFilter = device.newFilter("RT");
+    setFilterImage(refFilter, "color",  color);
+    setFilterImage(refFilter, "albedo", albedo);
+    setFilterImage(refFilter, "normal", normal);
+    setFilterImage(refFilter, "output", refOutput);
+    refFilter.set("hdr", true);
+    refFilter.commit();
+    refFilter.execute();
+    REQUIRE(device.getError() == Error::None);
+
+    size_t numErrors;
+    double avgError;
+    std::tie(numErrors, avgError) = compareImage(*output, *refOutput);
+    REQUIRE(numErrors == 0);
+  };
+
+  SECTION("color changed")
+  {
+    for (size_t i = 0; i < color->getSize(); ++i)
+      color->set(i, color->get(i) * 0.5f + rng.getFloat());
+    filter.updateData("color");
+    filter.commit();
+    filter.execute();
+    REQUIRE(device.getError() == Error::None);
+    checkOutput();
+  }
+
+  SECTION("albedo changed")
+  {
+    for (size_t i = 0; i < albedo->getSize(); ++i)
+      albedo->set(i, rng.getFloat());
+    filter.updateData("albedo");
+    filter.commit();
+    filter.execute();
+    REQUIRE(device.getError() == Error::None);
+    checkOutput();
+  }
+
+  SECTION("nothing changed")
+  {
+    filter.execute();
+    REQUIRE(device.getError() == Error::None);
+    checkOutput();
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TEST_CASE("weights cache", "[weights_cache]")
+{
+  const int W = 257;
+  const int H = 89;
+
+  const std::string cacheDir = getTempDir();
 
-  SECTION("2 filters / device: small -> large")
-  {
-    multiFilterNPerDeviceTest(device, {256, 3001});
-  }
+  DeviceRef refDevice = makeAndCommitDevice();
 
-  SECTION("3 filters / device: large -> small -> medium")
+  // The first device may populate the cache, while the second one must load it
+  for (int i = 0; i < 2; ++i)
   {
-    multiFilterNPerDeviceTest(device, {3001, 257, 1024});
-  }
+    DeviceRef device = makeDevice();
+    device.set("weightsCacheDir", cacheDir);
+    device.commit();
+    REQUIRE(device.getError() == Error::None);
+    REQUIRE(device.get<std::string>("weightsCacheDir") == cacheDir);
 
-  SECTION("3 filters / device: small -> medium -> large")
-  {
-    multiFilterNPerDeviceTest(device, {400, 1100, 3000});
+    runAndCompare(refDevice, device, W, H, [](FilterRef& filter, bool) { filter.set("hdr", true); });
   }
 }
 
 // -------------------------------------------------------------------------------------------------
 
-TEST_CASE("multiple devices", "[multi_device]")
+TEST_CASE("profile", "[profile]")
 {
-  const std::vector<int> sizes = {111, 256, 80};
+  const int W = 198;
+  const int H = 300;
 
-  std::vector<DeviceRef> devices;
-  std::vector<FilterRef> filters;
-  std::vector<std::shared_ptr<ImageBuffer>> images;
+  DeviceRef device = makeDevice();
+  device.set("profile", true);
+  device.commit();
+  REQUIRE(device.getError() == Error::None);
+  REQUIRE(device.get<bool>("profile"));
 
-  for (size_t i = 0; i < sizes.size(); ++i)
-  {
-    devices.push_back(makeAndCommitDevice());
+  FilterRef filter = device.newFilter("RT");
+  REQUIRE(bool(filter));
 
-    filters.push_back(devices[i].newFilter("RT"));
-    REQUIRE(bool(filters[i]));
+  auto image = makeImage(device, W, H);
+  setFilterImage(filter, "color",  image);
+  setFilterImage(filter, "output", image);
+  filter.commit();
+  REQUIRE(device.getError() == Error::None);
 
-    images.push_back(makeConstImage(devices[i], sizes[i], sizes[i], 3, DataType::Float16, 0.5f));
-    setFilterImage(filters[i], "color",  images[i]);
-    setFilterImage(filters[i], "output", images[i]);
+  filter.execute();
+  REQUIRE(device.getError() == Error::None);
 
-    filters[i].set("hdr", true);
-    filters[i].commit();
-    REQUIRE(devices[i].getError() == Error::None);
+  SECTION("Chrome trace")
+  {
+    const void* data;
+    size_t byteSize;
+    std::tie(data, byteSize) = filter.getData("profile");
+    REQUIRE(device.getError() == Error::None);
+    REQUIRE(data != nullptr);
+    const std::string trace(static_cast<const char*>(data), byteSize);
+    REQUIRE(trace.find("traceEvents") != std::string::npos);
   }
 
-  for (size_t i = 0; i < devices.size(); ++i)
+  SECTION("unknown data")
   {
-    filters[i].execute();
-    REQUIRE(devices[i].getError() == Error::None);
-    REQUIRE(isBetween(images[i], 0.1f, 1.0f)); // output sanity check
+    filter.getData("unknown");
+    REQUIRE(device.getError() == Error::InvalidArgument);
   }
 }
 
+TEST_CASE("profile disabled", "[profile]")
+{
+  DeviceRef device = makeDevice();
+  device.commit();
+  REQUIRE(device.getError() == Error::None);
+
+  FilterRef filter = device.newFilter("RT");
+  REQUIRE(bool(filter));
+
+  filter.getData("profile");
+  REQUIRE(device.getError() == Error::InvalidOperation);
+}
+
 // -------------------------------------------------------------------------------------------------
 
 TEST_CASE("shared image", "[shared_image]")
@@ -716,6 +1568,194 @@ TEST_CASE("filter update", "[filter_update]")
 
 // -------------------------------------------------------------------------------------------------
 
+TEST_CASE("balanced quality", "[quality]")
+{
+  const int W = 317;
+  const int H = 251;
+
+  DeviceRef device = makeAndCommitDevice();
+
+  // Faster but less accurate computations (e.g. Winograd convolution) must not change the result
+  // significantly
+  runAndCompare(device, device, W, H, [](FilterRef& filter, bool isRef)
+  {
+    filter.set("quality", isRef ? Quality::High : Quality::Balanced);
+  }, 0.01);
+}
+
+TEST_CASE("fast quality", "[quality]")
+{
+  const int W = 317;
+  const int H = 251;
+
+  DeviceRef device = makeAndCommitDevice();
+
+  auto input  = makeConstImage(device, W, H);
+  auto output = makeImage(device, W, H);
+
+  FilterRef filter = device.newFilter("RT");
+  REQUIRE(bool(filter));
+
+  setFilterImage(filter, "color",  input);
+  setFilterImage(filter, "output", output);
+  filter.set("quality", Quality::Fast);
+  REQUIRE(filter.get<Quality>("quality") == Quality::Fast);
+  filter.commit();
+  REQUIRE(device.getError() == Error::None);
+
+  // The smaller network may not be included in the build, but the filter must work in any case
+  filter.execute();
+  REQUIRE(device.getError() == Error::None);
+  REQUIRE(isBetween(output, 0.f, 1.f));
+
+  filter.set("quality", 3); // invalid quality mode
+  REQUIRE(device.getError() == Error::InvalidArgument);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TEST_CASE("reduced precision", "[reduced_precision]")
+{
+  const int W = 317;
+  const int H = 251;
+
+  DeviceRef refDevice = makeDevice();
+  if (refDevice.get<DeviceType>("type") != DeviceType::CPU)
+    return; // supported only by CPU devices
+  refDevice.set("reducedPrecision", false);
+  refDevice.commit();
+  REQUIRE(refDevice.getError() == Error::None);
+
+  DeviceRef device = makeDevice();
+  device.set("reducedPrecision", true);
+  device.commit();
+  REQUIRE(device.getError() == Error::None);
+
+  // Storing the activations and weights in FP16 (if supported) must not change the result
+  // significantly
+  runAndCompare(refDevice, device, W, H, nullptr, 0.01);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TEST_CASE("autotune", "[autotune]")
+{
+  const int W = 311;
+  const int H = 197;
+
+  const std::string cacheDir = getTempDir();
+
+  DeviceRef refDevice = makeDevice();
+  if (refDevice.get<DeviceType>("type") != DeviceType::CPU)
+    return; // supported only by CPU devices
+  refDevice.commit();
+  REQUIRE(refDevice.getError() == Error::None);
+
+  // The blocking parameters must not change the result
+  // The first device may tune the convolutions, while the second one must load the results
+  for (int i = 0; i < 2; ++i)
+  {
+    DeviceRef device = makeDevice();
+    device.set("autotune", true);
+    device.set("weightsCacheDir", cacheDir);
+    device.commit();
+    REQUIRE(device.getError() == Error::None);
+    REQUIRE(device.get<bool>("autotune"));
+
+    runAndCompare(refDevice, device, W, H);
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TEST_CASE("CPU tasking", "[cpu_tasking]")
+{
+  const int W = 1280;
+  const int H = 720;
+
+  DeviceRef refDevice = makeDevice();
+  if (refDevice.get<DeviceType>("type") != DeviceType::CPU)
+    return; // supported only by CPU devices
+  refDevice.commit();
+  REQUIRE(refDevice.getError() == Error::None);
+
+  // On systems without multiple NUMA nodes or core types (or without support for these in TBB), the
+  // device falls back to the default tasking
+  auto testDevice = [&](const char* paramName)
+  {
+    DeviceRef device = makeDevice();
+    device.set(paramName, true);
+    device.commit();
+    REQUIRE(device.getError() == Error::None);
+    REQUIRE(device.get<bool>(paramName));
+
+    runAndCompare(refDevice, device, W, H, [](FilterRef& filter, bool)
+    {
+      filter.set("maxMemoryMB", 0); // make sure there will be multiple tiles
+    });
+  };
+
+  SECTION("CPU tasking: NUMA")
+  {
+    // The tiles are distributed across the subdevices, which write the same output image
+    testDevice("numa");
+  }
+
+  SECTION("CPU tasking: performance cores only")
+  {
+    testDevice("performanceCoresOnly");
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+// Parallel for function of an application, which splits the range into chunks processed by
+// short-lived threads
+struct TestParallelFor
+{
+  std::atomic<int> numCalls{0};
+
+  static void run(void* userPtr, size_t n, ParallelForTask task, void* taskPtr)
+  {
+    TestParallelFor* self = static_cast<TestParallelFor*>(userPtr);
+    ++self->numCalls;
+
+    const size_t numChunks = std::min(n, size_t(4));
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < numChunks; ++i)
+      threads.emplace_back(task, taskPtr, i * n / numChunks, (i+1) * n / numChunks);
+    if (numChunks > 0)
+      task(taskPtr, 0, n / numChunks);
+    for (auto& thread : threads)
+      thread.join();
+  }
+};
+
+TEST_CASE("parallel for function", "[parallel_for]")
+{
+  const int W = 311;
+  const int H = 197;
+
+  DeviceRef refDevice = makeDevice();
+  if (refDevice.get<DeviceType>("type") != DeviceType::CPU)
+    return; // supported only by CPU devices
+  refDevice.commit();
+  REQUIRE(refDevice.getError() == Error::None);
+
+  TestParallelFor parallelFor;
+  DeviceRef device = newCPUDevice(TestParallelFor::run, &parallelFor);
+  REQUIRE(bool(device));
+  device.commit();
+  REQUIRE(device.getError() == Error::None);
+
+  runAndCompare(refDevice, device, W, H, [](FilterRef& filter, bool) { filter.set("hdr", true); });
+
+  // The device must have executed its parallel work with the function of the application
+  REQUIRE(parallelFor.numCalls > 0);
+}
+
+// -------------------------------------------------------------------------------------------------
+
 TEST_CASE("async filter", "[async_filter]")
 {
   const int W = 799;
@@ -758,6 +1798,48 @@ TEST_CASE("async filter", "[async_filter]")
   REQUIRE(device.getError() == Error::None);
 }
 
+TEST_CASE("async filter output", "[async_filter]")
+{
+  const int W = 1283;
+  const int H = 727;
+
+  DeviceRef device = makeAndCommitDevice();
+
+  auto input     = makeImage(device, W, H);
+  auto output    = makeImage(device, W, H);
+  auto refOutput = makeImage(device, W, H);
+  Random rng;
+  for (size_t i = 0; i < input->getSize(); ++i)
+    input->set(i, rng.getFloat());
+
+  FilterRef refFilter = device.newFilter("RT");
+  setFilterImage(refFilter, "color",  input);
+  setFilterImage(refFilter, "output", refOutput);
+  refFilter.set("maxMemoryMB", 0); // make sure there will be multiple tiles
+  refFilter.commit();
+  refFilter.execute();
+  REQUIRE(device.getError() == Error::None);
+
+  // Queue multiple executions, which must produce the same output as the blocking one
+  FilterRef filter = device.newFilter("RT");
+  setFilterImage(filter, "color",  input);
+  setFilterImage(filter, "output", output);
+  filter.set("maxMemoryMB", 0);
+  filter.commit();
+  REQUIRE(device.getError() == Error::None);
+
+  for (int i = 0; i < 3; ++i)
+    filter.executeAsync();
+
+  device.sync();
+  REQUIRE(device.getError() == Error::None);
+
+  size_t numErrors;
+  double avgError;
+  std::tie(numErrors, avgError) = compareImage(*output, *refOutput);
+  REQUIRE(numErrors == 0);
+}
+
 // -------------------------------------------------------------------------------------------------
 
 void imageSizeTest(DeviceRef& device, int W, int H, bool execute = true)
@@ -942,6 +2024,76 @@ TEST_CASE("progress monitor", "[progress]")
 
 // -------------------------------------------------------------------------------------------------
 
+// Tensor stored in a Tensor Archive (TZA)
+struct TZATensor
+{
+  std::string name;
+  std::vector<uint32_t> dims;
+  std::string layout;
+  float value; // all elements have the same value
+};
+
+void writeBytes(std::vector<uint8_t>& blob, const void* ptr, size_t size)
+{
+  blob.insert(blob.end(), static_cast<const uint8_t*>(ptr), static_cast<const uint8_t*>(ptr) + size);
+}
+
+template<typename T>
+void writeValue(std::vector<uint8_t>& blob, T value)
+{
+  writeBytes(blob, &value, sizeof(value));
+}
+
+// Writes tensors and metadata to a TZA blob in memory
+std::vector<uint8_t> makeTZA(const std::vector<TZATensor>& tensors,
+                             const std::vector<std::pair<std::string, std::string>>& metadata)
+{
+  std::vector<uint8_t> blob;
+
+  writeValue(blob, uint16_t(0x41D7)); // magic
+  writeValue(blob, uint8_t(2));       // major version
+  writeValue(blob, uint8_t(1));       // minor version
+  writeValue(blob, uint64_t(0));      // table offset (written later)
+
+  std::vector<uint64_t> offsets;
+  for (const auto& tensor : tensors)
+  {
+    offsets.push_back(blob.size());
+    size_t numElements = 1;
+    for (uint32_t dim : tensor.dims)
+      numElements *= dim;
+    for (size_t i = 0; i < numElements; ++i)
+      writeValue(blob, tensor.value);
+  }
+
+  const uint64_t tableOffset = blob.size();
+  std::memcpy(&blob[4], &tableOffset, sizeof(tableOffset));
+
+  writeValue(blob, uint32_t(tensors.size()));
+  for (size_t i = 0; i < tensors.size(); ++i)
+  {
+    writeValue(blob, uint16_t(tensors[i].name.size()));
+    writeBytes(blob, tensors[i].name.data(), tensors[i].name.size());
+    writeValue(blob, uint8_t(tensors[i].dims.size()));
+    for (uint32_t dim : tensors[i].dims)
+      writeValue(blob, dim);
+    writeBytes(blob, tensors[i].layout.data(), tensors[i].layout.size());
+    writeValue(blob, 'f');
+    writeValue(blob, offsets[i]);
+  }
+
+  writeValue(blob, uint32_t(metadata.size()));
+  for (const auto& entry : metadata)
+  {
+    writeValue(blob, uint16_t(entry.first.size()));
+    writeBytes(blob, entry.first.data(), entry.first.size());
+    writeValue(blob, uint32_t(entry.second.size()));
+    writeBytes(blob, entry.second.data(), entry.second.size());
+  }
+
+  return blob;
+}
+
 TEST_CASE("user weights", "[user_weights]")
 {
   DeviceRef device = makeAndCommitDevice();
@@ -990,6 +2142,165 @@ TEST_CASE("user weights", "[user_weights]")
     filter.commit();
     REQUIRE(device.getError() == Error::InvalidOperation);
   }
+
+  // Single-level U-Net with zero weights
+  const std::vector<TZATensor> tensors =
+  {
+    {"enc_conv0.weight", {8, 3, 3, 3},  "oihw", 0.f}, {"enc_conv0.bias", {8}, "x", 0.f},
+    {"dec_conv1.weight", {8, 8, 3, 3},  "oihw", 0.f}, {"dec_conv1.bias", {8}, "x", 0.f},
+    {"dec_conv0.weight", {3, 11, 3, 3}, "oihw", 0.f}, {"dec_conv0.bias", {3}, "x", 0.f},
+  };
+
+  SECTION("topology")
+  {
+    filter.commit();
+    REQUIRE(device.getError() == Error::None);
+    const int defaultTileOverlap = filter.get<int>("tileOverlap");
+
+    auto weights = makeTZA(tensors, {{"topology", "enc_conv0 input     -     relu pool\n"
+                                                  "dec_conv1 enc_conv0 -     relu upsample\n"
+                                                  "dec_conv0 dec_conv1 input relu -\n"}});
+    filter.setData("weights", weights.data(), weights.size());
+    filter.commit();
+    REQUIRE(device.getError() == Error::None);
+
+    // The tile overlap is derived from the receptive field of the network (10 pixels)
+    const int tileOverlap = filter.get<int>("tileOverlap");
+    REQUIRE(tileOverlap >= 5);
+    REQUIRE(tileOverlap < defaultTileOverlap);
+    REQUIRE(filter.get<int>("tileAlignment") % 2 == 0);
+
+    filter.execute();
+    REQUIRE(device.getError() == Error::None);
+    REQUIRE(isBetween(image, 0.f, 0.f));
+  }
+
+  SECTION("invalid topology")
+  {
+    auto weights = makeTZA(tensors, {{"topology", "enc_conv0 input     -         relu pool\n"
+                                                  "dec_conv1 enc_conv0 dec_conv0 relu upsample\n"
+                                                  "dec_conv0 dec_conv1 input     relu -\n"}});
+    filter.setData("weights", weights.data(), weights.size());
+    filter.commit();
+    REQUIRE(device.getError() == Error::InvalidOperation);
+  }
+
+  SECTION("quantized")
+  {
+    // Weights with calibrated input scales, which may be used for INT8 inference in fast quality mode
+    const std::vector<TZATensor> quantTensors =
+    {
+      {"enc_conv0.weight", {8, 3, 3, 3},  "oihw", 0.05f},  {"enc_conv0.bias", {8}, "x", 0.01f},
+      {"dec_conv1.weight", {8, 8, 3, 3},  "oihw", 0.02f},  {"dec_conv1.bias", {8}, "x", 0.01f},
+      {"dec_conv0.weight", {3, 11, 3, 3}, "oihw", 0.003f}, {"dec_conv0.bias", {3}, "x", 0.01f},
+      {"enc_conv0.input_scale", {1}, "x", 1.f / 255.f},
+      {"dec_conv1.input_scale", {1}, "x", 2.f / 255.f},
+      {"dec_conv0.input_scale", {1}, "x", 4.f / 255.f},
+    };
+
+    auto weights = makeTZA(quantTensors, {{"topology", "enc_conv0 input     -     relu pool\n"
+                                                       "dec_conv1 enc_conv0 -     relu upsample\n"
+                                                       "dec_conv0 dec_conv1 input relu -\n"}});
+
+    // The result must be close to the result without quantization
+    runAndCompare(device, device, W, H, [&](FilterRef& curFilter, bool isRef)
+    {
+      curFilter.setData("weights", weights.data(), weights.size());
+      curFilter.set("quality", isRef ? Quality::High : Quality::Fast);
+    }, 0.02);
+  }
+
+  SECTION("weights path")
+  {
+    const std::string weightsPath = getTempDir() + "/oidn_test_weights.tza";
+
+    auto weights = makeTZA(tensors, {{"topology", "enc_conv0 input     -     relu pool\n"
+                                                  "dec_conv1 enc_conv0 -     relu upsample\n"
+                                                  "dec_conv0 dec_conv1 input relu -\n"}});
+    {
+      std::ofstream file(weightsPath, std::ios::binary);
+      file.write(reinterpret_cast<const char*>(weights.data()), weights.size());
+      REQUIRE(!file.fail());
+    }
+
+    filter.set("weightsPath", weightsPath);
+    REQUIRE(filter.get<std::string>("weightsPath") == weightsPath);
+
+    // Another filter mapping the same file shares the weights with the first one
+    FilterRef filter2 = device.newFilter("RT");
+    auto image2 = makeConstImage(device, W, H);
+    setFilterImage(filter2, "color",  image2);
+    setFilterImage(filter2, "output", image2);
+    filter2.set("weightsPath", weightsPath.c_str());
+
+    for (FilterRef* curFilter : {&filter, &filter2})
+    {
+      curFilter->commit();
+      REQUIRE(device.getError() == Error::None);
+      REQUIRE(curFilter->get<int>("tileOverlap") >= 5);
+
+      curFilter->execute();
+      REQUIRE(device.getError() == Error::None);
+    }
+
+    REQUIRE(isBetween(image,  0.f, 0.f));
+    REQUIRE(isBetween(image2, 0.f, 0.f));
+
+    std::remove(weightsPath.c_str());
+
+    filter2.set("weightsPath", weightsPath + ".missing");
+    filter2.commit();
+    REQUIRE(device.getError() == Error::InvalidOperation);
+  }
+
+  SECTION("shared weights")
+  {
+    const std::string topology = "enc_conv0 input     -     relu pool\n"
+                                 "dec_conv1 enc_conv0 -     relu upsample\n"
+                                 "dec_conv0 dec_conv1 input relu -\n";
+
+    // Separate copies of the same weights, which share their final weights
+    auto weights  = makeTZA(tensors, {{"topology", topology}});
+    auto weights2 = weights;
+
+    FilterRef filter2 = device.newFilter("RT");
+    auto image2 = makeConstImage(device, W, H);
+    setFilterImage(filter2, "color",  image2);
+    setFilterImage(filter2, "output", image2);
+
+    filter.setData("weights",  weights.data(),  weights.size());
+    filter2.setData("weights", weights2.data(), weights2.size());
+
+    for (FilterRef* curFilter : {&filter, &filter2})
+    {
+      curFilter->commit();
+      REQUIRE(device.getError() == Error::None);
+      curFilter->execute();
+      REQUIRE(device.getError() == Error::None);
+    }
+
+    REQUIRE(isBetween(image,  0.f, 0.f));
+    REQUIRE(isBetween(image2, 0.f, 0.f));
+
+    // Changing the contents of the weights of one filter must not affect the other filter
+    std::vector<TZATensor> tensors2 = tensors;
+    tensors2[5].value = 0.5f; // dec_conv0.bias
+    const auto newWeights2 = makeTZA(tensors2, {{"topology", topology}});
+    REQUIRE(newWeights2.size() == weights2.size());
+    std::copy(newWeights2.begin(), newWeights2.end(), weights2.begin());
+    filter2.updateData("weights");
+
+    for (FilterRef* curFilter : {&filter, &filter2})
+    {
+      curFilter->commit();
+      REQUIRE(device.getError() == Error::None);
+      curFilter->execute();
+      REQUIRE(device.getError() == Error::None);
+    }
+
+    REQUIRE(isBetween(image,  0.f, 0.f));
+    REQUIRE(isBetween(image2, 0.1f, 1.f));
+  }
 }
 
 #endif // defined(OIDN_FILTER_RT)
@@ -87,6 +87,7 @@ OIDN_NAMESPACE_BEGIN
     switch (quality)
     {
     case Quality::Default:  sm << "default";  break;
+    case Quality::Fast:     sm << "fast";     break;
     case Quality::High:     sm << "high";     break;
     case Quality::Balanced: sm << "balanced"; break;
     default:
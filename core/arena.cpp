@@ -39,6 +39,17 @@ OIDN_NAMESPACE_BEGIN
     }
   }
 
+  size_t ScratchArenaManager::getByteSize() const
+  {
+    size_t byteSize = 0;
+    for (const auto& item : allocs)
+    {
+      if (item.second.heap)
+        byteSize += item.second.heap->getByteSize();
+    }
+    return byteSize;
+  }
+
   // Attaches a scratch arena and returns the heap that backs its memory
   Heap* ScratchArenaManager::attach(ScratchArena* arena)
   {
@@ -48,6 +48,9 @@ OIDN_NAMESPACE_BEGIN
     // Trim the heap(s) to the minimum size required by the attached arenas
     void trim();
 
+    // Returns the total size of the allocated heaps
+    size_t getByteSize() const;
+
   private:
     // Allocation consisting of a heap and a set of scratch arenas sharing this heap
     struct Alloc
@@ -49,6 +49,21 @@ OIDN_NAMESPACE_BEGIN
     dirty = true;
   }
 
+  void ArenaPlanner::addPersistentAllocs(const std::vector<int>& allocIDs)
+  {
+    for (int allocID : allocIDs)
+      checkAllocID(allocID);
+
+    for (int allocID : allocIDs)
+    {
+      Alloc* cur = allocs[allocID].get();
+      cur->firstOpID = 0;
+      cur->lastOpID  = std::numeric_limits<int>::max();
+    }
+
+    dirty = true;
+  }
+
   void ArenaPlanner::commit()
   {
     if (!dirty)
@@ -19,6 +19,10 @@ public:
   // allocations to be stored consecutively in memory
   void addDepAllocs(int opID, const std::vector<int>& allocIDs, bool concatAllocs = false);
 
+  // Makes the specified allocations live during all operations, thus their contents are preserved
+  // between consecutive executions of the sequence of operations
+  void addPersistentAllocs(const std::vector<int>& allocIDs);
+
   // Commits changes to the plan, after which it's possible to query the offsets of the allocations
   void commit();
 
@@ -0,0 +1,41 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "atomic_file.h"
+#include <fstream>
+#include <random>
+#include <cstdio>
+
+OIDN_NAMESPACE_BEGIN
+
+  bool writeFileAtomic(const std::string& path, const std::function<void(std::ostream&)>& writeFunc)
+  {
+    std::random_device rd;
+    const std::string tempPath = path + ".tmp" + toString(rd());
+
+    {
+      std::ofstream file(tempPath, std::ios::binary);
+      if (!file.fail())
+        writeFunc(file);
+
+      if (file.fail())
+      {
+        file.close();
+        std::remove(tempPath.c_str());
+        return false;
+      }
+    }
+
+  #if defined(_WIN32)
+    std::remove(path.c_str()); // rename does not replace existing files on Windows
+  #endif
+    if (std::rename(tempPath.c_str(), path.c_str()) != 0)
+    {
+      std::remove(tempPath.c_str());
+      return false;
+    }
+
+    return true;
+  }
+
+OIDN_NAMESPACE_END
\ No newline at end of file
@@ -0,0 +1,17 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "common/common.h"
+#include <functional>
+#include <ostream>
+
+OIDN_NAMESPACE_BEGIN
+
+  // Writes a binary file with the specified function, replacing the file if it already exists
+  // The file is written under a unique temporary name first and then renamed, so other processes
+  // never see a partially written file. Returns false if the file could not be written.
+  bool writeFileAtomic(const std::string& path, const std::function<void(std::ostream&)>& writeFunc);
+
+OIDN_NAMESPACE_END
\ No newline at end of file
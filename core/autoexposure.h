@@ -41,6 +41,8 @@ OIDN_NAMESPACE_BEGIN
     void setDst(const Ref<Record<float>>& dst) { this->dst = dst; }
     float* getDstPtr() const { return dst->getPtr(); }
 
+    size_t getNumBytes() const override { return srcDesc.getByteSize(); }
+
   protected:
     ImageDesc srcDesc;
     Ref<Image> src;
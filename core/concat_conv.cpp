@@ -52,4 +52,16 @@ OIDN_NAMESPACE_BEGIN
     updateDst();
   }
 
+  size_t ConcatConv::getNumBytes() const
+  {
+    return src1Desc.getByteSize() + src2Desc.getByteSize() + weightDesc.getByteSize() +
+           biasDesc.getByteSize() + dstDesc.getByteSize();
+  }
+
+  double ConcatConv::getNumFlops() const
+  {
+    return 2. * weightDesc.getO() * weightDesc.getI() * weightDesc.getH() * weightDesc.getW() *
+           src1Desc.getH() * src1Desc.getW();
+  }
+
 OIDN_NAMESPACE_END
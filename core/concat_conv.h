@@ -16,6 +16,7 @@ OIDN_NAMESPACE_BEGIN
     TensorDesc biasDesc;
     Activation activation;
     bool fastMath; // prefer performance over accuracy
+    float srcScale; // calibrated quantization scale of the concatenated sources, 0 if unknown
   };
 
   class ConcatConv : public Op, protected ConcatConvDesc
@@ -30,6 +31,9 @@ OIDN_NAMESPACE_BEGIN
     void setBias(const Ref<Tensor>& bias);
     void setDst(const Ref<Tensor>& dst);
 
+    size_t getNumBytes() const override;
+    double getNumFlops() const override;
+
   protected:
     virtual void updateSrc() {}
     virtual void updateBias() {}
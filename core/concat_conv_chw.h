@@ -19,6 +19,9 @@ OIDN_NAMESPACE_BEGIN
 
     void setWeight(const Ref<Tensor>& weight) { conv->setWeight(weight); }
 
+    // The underlying convolution of the pre-concatenated source, which may be scheduled directly
+    Conv* getConv() const { return conv.get(); }
+
     void finalize() override { conv->finalize(); }
     void submit() override { conv->submit(); }
 
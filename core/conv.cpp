@@ -63,9 +63,36 @@ OIDN_NAMESPACE_BEGIN
       throw std::invalid_argument("invalid convolution weight");
 
     this->weight = weight;
+    packedWeight.reset(); // the packed weight has to match the new weight
     updateWeight();
   }
 
+  void Conv::packWeight(Tensor& packedWeight) const
+  {
+    throw std::logic_error("convolution does not support packed weights");
+  }
+
+  void Conv::setPackedWeight(const Ref<Tensor>& packedWeight)
+  {
+    if (!packedWeight || packedWeight->getDesc() != getPackedWeightDesc())
+      throw std::invalid_argument("invalid convolution packed weight");
+
+    this->packedWeight = packedWeight;
+  }
+
+  const Ref<Tensor>& Conv::getPackedWeight()
+  {
+    if (!packedWeight)
+    {
+      if (!weight)
+        throw std::logic_error("convolution weight not set");
+      packedWeight = makeRef<HostTensor>(getPackedWeightDesc());
+      packWeight(*packedWeight);
+    }
+
+    return packedWeight;
+  }
+
   void Conv::setBias(const Ref<Tensor>& bias)
   {
     if (!bias || bias->getDesc() != biasDesc)
@@ -84,4 +111,17 @@ OIDN_NAMESPACE_BEGIN
     updateDst();
   }
 
+  size_t Conv::getNumBytes() const
+  {
+    return srcDesc.getByteSize() + weightDesc.getByteSize() + biasDesc.getByteSize() +
+           dstDesc.getByteSize();
+  }
+
+  double Conv::getNumFlops() const
+  {
+    // The convolution is computed at the source resolution (before pooling or upsampling)
+    return 2. * weightDesc.getO() * weightDesc.getI() * weightDesc.getH() * weightDesc.getW() *
+           srcDesc.getH() * srcDesc.getW();
+  }
+
 OIDN_NAMESPACE_END
@@ -31,6 +31,7 @@ OIDN_NAMESPACE_BEGIN
     Activation activation;
     PostOp postOp;
     bool fastMath; // prefer performance over accuracy
+    float srcScale; // calibrated quantization scale of the source for INT8 inference, 0 if unknown
   };
 
   // Convolution
@@ -47,15 +48,37 @@ OIDN_NAMESPACE_BEGIN
     void setBias(const Ref<Tensor>& bias);
     void setDst(const Ref<Tensor>& dst);
 
+    // Some implementations convert the weight to a private format once (e.g. Winograd transformed or
+    // quantized weights), which is stored in an opaque packed weight tensor. The packed weight
+    // depends only on the descriptor and the weight, thus it can be shared by multiple convolutions.
+    // The descriptor is empty if the weight is used directly.
+    virtual TensorDesc getPackedWeightDesc() const { return TensorDesc(); }
+
+    // Suffix of the name of the packed weight, which identifies its format among the cached weights
+    virtual std::string getPackedWeightSuffix() const { return ".packed_weight"; }
+
+    // Converts the weight, which must be already set, to the packed format
+    virtual void packWeight(Tensor& packedWeight) const;
+
+    // Sets the packed weight, otherwise the convolution packs its own weight when submitted
+    void setPackedWeight(const Ref<Tensor>& packedWeight);
+
+    size_t getNumBytes() const override;
+    double getNumFlops() const override;
+
   protected:
     virtual void updateSrc() {}
     virtual void updateWeight() {}
     virtual void updateBias() {}
     virtual void updateDst() {}
 
+    // Gets the packed weight, packing the weight if the packed weight has not been set
+    const Ref<Tensor>& getPackedWeight();
+
     TensorDesc dstDesc;
     Ref<Tensor> src;
     Ref<Tensor> weight;
+    Ref<Tensor> packedWeight;
     Ref<Tensor> bias;
     Ref<Tensor> dst;
   };
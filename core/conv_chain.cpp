@@ -0,0 +1,127 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "conv_chain.h"
+
+OIDN_NAMESPACE_BEGIN
+
+  ConvChain::ConvChain(const std::vector<ConvDesc>& convDescs)
+    : convDescs(convDescs),
+      weights(convDescs.size()),
+      biases(convDescs.size())
+  {
+    if (convDescs.size() < 2)
+      throw std::invalid_argument("convolution chain must have at least two convolutions");
+
+    for (size_t i = 0; i < convDescs.size(); ++i)
+    {
+      const ConvDesc& desc = convDescs[i];
+      if (desc.srcDesc.getRank() != 3 || desc.weightDesc.getRank() != 4 ||
+          desc.weightDesc.getI() != desc.srcDesc.getC() ||
+          desc.weightDesc.getPaddedI() != desc.srcDesc.getPaddedC())
+        throw std::invalid_argument("invalid convolution chain shape");
+
+      if (i + 1 < convDescs.size())
+      {
+        // The intermediate convolutions preserve the spatial size
+        const TensorDesc& nextSrcDesc = convDescs[i+1].srcDesc;
+        if (desc.postOp != PostOp::None ||
+            nextSrcDesc.getC() != desc.weightDesc.getO() ||
+            nextSrcDesc.getPaddedC() != desc.weightDesc.getPaddedO() ||
+            nextSrcDesc.getH() != desc.srcDesc.getH() || nextSrcDesc.getW() != desc.srcDesc.getW() ||
+            nextSrcDesc.layout != desc.srcDesc.layout || nextSrcDesc.dataType != desc.srcDesc.dataType)
+          throw std::invalid_argument("invalid convolution chain shape");
+      }
+    }
+
+    // The destination is the same as the destination of the last convolution
+    const ConvDesc& lastDesc = convDescs.back();
+    TensorDims dstDims;
+    switch (lastDesc.postOp)
+    {
+    case PostOp::None:
+      dstDims = {lastDesc.weightDesc.getO(), lastDesc.srcDesc.getH(), lastDesc.srcDesc.getW()};
+      break;
+
+    case PostOp::Pool:
+      if (lastDesc.srcDesc.getH() % 2 != 0 || lastDesc.srcDesc.getW() % 2 != 0)
+        throw std::invalid_argument("invalid pooling source shape");
+      dstDims = {lastDesc.weightDesc.getO(), lastDesc.srcDesc.getH() / 2, lastDesc.srcDesc.getW() / 2};
+      break;
+
+    case PostOp::Upsample:
+      dstDims = {lastDesc.weightDesc.getO(), lastDesc.srcDesc.getH() * 2, lastDesc.srcDesc.getW() * 2};
+      break;
+
+    default:
+      throw std::invalid_argument("unsupported convolution postop");
+    }
+
+    TensorDims dstPaddedDims = dstDims;
+    dstPaddedDims[0] = lastDesc.weightDesc.getPaddedO();
+
+    dstDesc = {dstDims, dstPaddedDims, lastDesc.srcDesc.layout, lastDesc.srcDesc.dataType};
+  }
+
+  void ConvChain::setSrc(const Ref<Tensor>& src)
+  {
+    if (!src || src->getDesc() != convDescs.front().srcDesc)
+      throw std::invalid_argument("invalid convolution chain source");
+
+    this->src = src;
+    updateSrc();
+  }
+
+  void ConvChain::setWeight(int convIndex, const Ref<Tensor>& weight)
+  {
+    if (convIndex < 0 || convIndex >= getNumConvs())
+      throw std::out_of_range("invalid convolution chain index");
+    if (!weight || weight->getDesc() != convDescs[convIndex].weightDesc)
+      throw std::invalid_argument("invalid convolution chain weight");
+
+    weights[convIndex] = weight;
+    updateWeight(convIndex);
+  }
+
+  void ConvChain::setBias(int convIndex, const Ref<Tensor>& bias)
+  {
+    if (convIndex < 0 || convIndex >= getNumConvs())
+      throw std::out_of_range("invalid convolution chain index");
+    if (!bias || bias->getDesc() != convDescs[convIndex].biasDesc)
+      throw std::invalid_argument("invalid convolution chain bias");
+
+    biases[convIndex] = bias;
+    updateBias(convIndex);
+  }
+
+  void ConvChain::setDst(const Ref<Tensor>& dst)
+  {
+    if (!dst || dst->getDesc() != dstDesc)
+      throw std::invalid_argument("invalid convolution chain destination");
+
+    this->dst = dst;
+    updateDst();
+  }
+
+  size_t ConvChain::getNumBytes() const
+  {
+    // The intermediate outputs are not stored in memory at full size
+    size_t numBytes = convDescs.front().srcDesc.getByteSize() + dstDesc.getByteSize();
+    for (const auto& desc : convDescs)
+      numBytes += desc.weightDesc.getByteSize() + desc.biasDesc.getByteSize();
+    return numBytes;
+  }
+
+  double ConvChain::getNumFlops() const
+  {
+    double numFlops = 0;
+    for (const auto& desc : convDescs)
+    {
+      numFlops += 2. * desc.weightDesc.getO() * desc.weightDesc.getI() *
+                  desc.weightDesc.getH() * desc.weightDesc.getW() *
+                  desc.srcDesc.getH() * desc.srcDesc.getW();
+    }
+    return numFlops;
+  }
+
+OIDN_NAMESPACE_END
@@ -0,0 +1,46 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "conv.h"
+#include <vector>
+
+OIDN_NAMESPACE_BEGIN
+
+  // Chain of convolutions, each consuming only the output of the previous one, which may be executed
+  // in row bands such that the intermediate outputs never need to be stored at full size
+  // Only the last convolution may have a post-op.
+  class ConvChain : public Op
+  {
+  public:
+    ConvChain(const std::vector<ConvDesc>& convDescs);
+
+    int getNumConvs() const { return int(convDescs.size()); }
+    TensorDesc getDstDesc() const { return dstDesc; }
+    Ref<Tensor> getDst() const { return dst; }
+
+    void setSrc(const Ref<Tensor>& src);
+    void setWeight(int convIndex, const Ref<Tensor>& weight);
+    void setBias(int convIndex, const Ref<Tensor>& bias);
+    void setDst(const Ref<Tensor>& dst);
+
+    size_t getNumBytes() const override;
+    double getNumFlops() const override;
+
+  protected:
+    virtual void updateSrc() {}
+    virtual void updateWeight(int convIndex) {}
+    virtual void updateBias(int convIndex) {}
+    virtual void updateDst() {}
+
+    std::vector<ConvDesc> convDescs;
+    TensorDesc dstDesc;
+
+    Ref<Tensor> src;
+    std::vector<Ref<Tensor>> weights;
+    std::vector<Ref<Tensor>> biases;
+    Ref<Tensor> dst;
+  };
+
+OIDN_NAMESPACE_END
@@ -3,7 +3,7 @@
 
 #pragma once
 
-#include "common/platform.h"
+#include "exception.h"
 
 OIDN_NAMESPACE_BEGIN
 
@@ -91,6 +91,9 @@ OIDN_NAMESPACE_BEGIN
     // Get default values from environment variables
     if (getEnvVar("OIDN_VERBOSE", verbose))
       error.setVerbose(verbose);
+    getEnvVar("OIDN_WEIGHTS_CACHE_DIR", weightsCacheDir);
+    getEnvVar("OIDN_PROFILE", profiling);
+    getEnvVar("OIDN_MAX_MEMORY_MB", maxMemoryMB);
   }
 
   void Device::setError(Device* device, Error code, const std::string& message)
@@ -179,12 +182,18 @@ OIDN_NAMESPACE_BEGIN
       return OIDN_VERSION_PATCH;
     else if (name == "verbose")
       return verbose;
+    else if (name == "profile")
+      return profiling;
     else if (name == "systemMemorySupported")
       return systemMemorySupported;
     else if (name == "managedMemorySupported")
       return managedMemorySupported;
     else if (name == "externalMemoryTypes")
       return static_cast<int>(externalMemoryTypes);
+    else if (name == "maxMemoryMB")
+      return maxMemoryMB;
+    else if (name == "memoryUsageMB")
+      return int(ceil_div(getMemoryUsage(), size_t(1024*1024)));
     else
       throw Exception(Error::InvalidArgument, "unknown device parameter or type mismatch: '" + name + "'");
   }
@@ -201,6 +210,43 @@ OIDN_NAMESPACE_BEGIN
       else if (verbose != value)
         printWarning("OIDN_VERBOSE environment variable overrides device parameter");
     }
+    else if (name == "profile")
+    {
+      if (!isEnvVar("OIDN_PROFILE"))
+        profiling = value;
+      else if (profiling != bool(value))
+        printWarning("OIDN_PROFILE environment variable overrides device parameter");
+    }
+    else if (name == "maxMemoryMB")
+    {
+      if (!isEnvVar("OIDN_MAX_MEMORY_MB"))
+        maxMemoryMB = value;
+      else if (maxMemoryMB != value)
+        printWarning("OIDN_MAX_MEMORY_MB environment variable overrides device parameter");
+    }
+    else
+      printWarning("unknown device parameter or type mismatch: '" + name + "'");
+
+    dirty = true;
+  }
+
+  const char* Device::getString(const std::string& name)
+  {
+    if (name == "weightsCacheDir")
+      return weightsCacheDir.c_str();
+    else
+      throw Exception(Error::InvalidArgument, "unknown device parameter or type mismatch: '" + name + "'");
+  }
+
+  void Device::setString(const std::string& name, const std::string& value)
+  {
+    if (name == "weightsCacheDir")
+    {
+      if (!isEnvVar("OIDN_WEIGHTS_CACHE_DIR"))
+        weightsCacheDir = value;
+      else if (weightsCacheDir != value)
+        printWarning("OIDN_WEIGHTS_CACHE_DIR environment variable overrides device parameter");
+    }
     else
       printWarning("unknown device parameter or type mismatch: '" + name + "'");
 
@@ -291,4 +337,73 @@ OIDN_NAMESPACE_BEGIN
       subdevice->trimScratch();
   }
 
+  size_t Device::getScratchByteSize() const
+  {
+    size_t byteSize = 0;
+    for (const auto& subdevice : subdevices)
+      byteSize += subdevice->getScratchByteSize();
+    return byteSize;
+  }
+
+  // Returns the maximum amount of memory the filter may use without exceeding the memory budget,
+  // considering the memory kept by the other filters
+  size_t Device::getMaxFilterMemoryByteSize(const Filter* filter, const void* weightsKey) const
+  {
+    if (!hasMemoryBudget())
+      return SIZE_MAX;
+
+    size_t otherByteSize = 0;
+    std::unordered_map<const void*, size_t> otherWeightsByteSizes;
+    for (const auto& item : filterMemoryUsages)
+    {
+      if (item.first == filter)
+        continue;
+      const FilterMemoryUsage& usage = item.second;
+      otherByteSize += usage.privateScratchByteSize;
+      if (usage.weightsKey != weightsKey)
+      {
+        size_t& weightsByteSize = otherWeightsByteSizes[usage.weightsKey];
+        weightsByteSize = max(weightsByteSize, usage.weightsByteSize);
+      }
+    }
+
+    for (const auto& item : otherWeightsByteSizes)
+      otherByteSize += item.second;
+
+    const size_t maxByteSize = size_t(maxMemoryMB) * 1024 * 1024;
+    return (otherByteSize < maxByteSize) ? (maxByteSize - otherByteSize) : 0;
+  }
+
+  void Device::setFilterMemoryUsage(const Filter* filter, size_t privateScratchByteSize,
+                                    const void* weightsKey, size_t weightsByteSize)
+  {
+    filterMemoryUsages[filter] = {privateScratchByteSize, weightsKey, weightsByteSize};
+  }
+
+  void Device::removeFilterMemoryUsage(const Filter* filter)
+  {
+    filterMemoryUsages.erase(filter);
+  }
+
+  bool Device::isMemoryBudgetExceeded() const
+  {
+    return hasMemoryBudget() && getMemoryUsage() > size_t(maxMemoryMB) * 1024 * 1024;
+  }
+
+  // Returns the total amount of memory allocated for the filters (scratch heaps and weights)
+  size_t Device::getMemoryUsage() const
+  {
+    size_t byteSize = getScratchByteSize();
+    std::unordered_map<const void*, size_t> weightsByteSizes;
+    for (const auto& item : filterMemoryUsages)
+    {
+      size_t& weightsByteSize = weightsByteSizes[item.second.weightsKey];
+      weightsByteSize = max(weightsByteSize, item.second.weightsByteSize);
+    }
+
+    for (const auto& item : weightsByteSizes)
+      byteSize += item.second;
+    return byteSize;
+  }
+
 OIDN_NAMESPACE_END
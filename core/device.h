@@ -10,6 +10,7 @@
 #include "thread.h"
 #include "tensor_layout.h"
 #include "data.h"
+#include <unordered_map>
 
 OIDN_NAMESPACE_BEGIN
 
@@ -64,6 +65,8 @@ OIDN_NAMESPACE_BEGIN
 
     virtual int getInt(const std::string& name);
     virtual void setInt(const std::string& name, int value);
+    virtual const char* getString(const std::string& name);
+    virtual void setString(const std::string& name, const std::string& value);
 
     bool isCommitted() const { return committed; }
     void checkCommitted();
@@ -106,6 +109,24 @@ OIDN_NAMESPACE_BEGIN
     bool isManagedMemorySupported() const { return managedMemorySupported; }
     ExternalMemoryTypeFlags getExternalMemoryTypes() const { return externalMemoryTypes; }
     void trimScratch();
+    size_t getScratchByteSize() const;
+
+    // Device-wide memory budget shared by all filters
+    // The scratch memory of filters is shared, so it is limited only by the memory that other
+    // filters keep for themselves (weights and non-shared scratch)
+    bool hasMemoryBudget() const { return maxMemoryMB >= 0; }
+    bool isMemoryBudgetExceeded() const;
+    size_t getMaxFilterMemoryByteSize(const Filter* filter, const void* weightsKey) const;
+    void setFilterMemoryUsage(const Filter* filter, size_t privateScratchByteSize,
+                              const void* weightsKey, size_t weightsByteSize);
+    void removeFilterMemoryUsage(const Filter* filter);
+    size_t getMemoryUsage() const;
+
+    // Persistent weights cache
+    const std::string& getWeightsCacheDir() const { return weightsCacheDir; }
+
+    // Profiling
+    bool isProfiling() const { return profiling; }
 
     // Synchronizes all subdevices (does not block)
     virtual void submitBarrier() {}
@@ -133,6 +154,10 @@ OIDN_NAMESPACE_BEGIN
     bool managedMemorySupported = false;
     ExternalMemoryTypeFlags externalMemoryTypes;
 
+    std::string weightsCacheDir; // directory of the persistent weights cache, disabled if empty
+    bool profiling = false;      // record the execution time of every operation
+    int maxMemoryMB = -1;        // memory budget of all filters in MBs, disabled if < 0
+
     // State
     bool dirty = true;
     bool committed = false;
@@ -152,6 +177,16 @@ OIDN_NAMESPACE_BEGIN
     ThreadLocal<ErrorState> error;
     ErrorFunction errorFunc = nullptr;
     void* errorUserPtr = nullptr;
+
+    // Memory kept by a filter which is not shared with other filters
+    struct FilterMemoryUsage
+    {
+      size_t privateScratchByteSize; // scratch which must be preserved between executions
+      const void* weightsKey;        // filters using the same built-in weights share them
+      size_t weightsByteSize;
+    };
+
+    std::unordered_map<const Filter*, FilterMemoryUsage> filterMemoryUsages;
   };
 
   // SYCL devices require additional methods exposed for the API implementation
@@ -15,6 +15,13 @@ OIDN_NAMESPACE_BEGIN
     virtual Ref<Device> newDevice(const Ref<PhysicalDevice>& physicalDevice) = 0;
   };
 
+  class CPUDeviceFactoryBase : public DeviceFactory
+  {
+  public:
+    using DeviceFactory::newDevice;
+    virtual Ref<Device> newDevice(ParallelForFunction parallelForFunc, void* parallelForUserPtr) = 0;
+  };
+
   class SYCLDeviceFactoryBase : public DeviceFactory
   {
   public:
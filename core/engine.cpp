@@ -2,7 +2,7 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "engine.h"
-#include "conv.h"
+#include "conv_chain.h"
 
 OIDN_NAMESPACE_BEGIN
 
@@ -88,6 +88,16 @@ OIDN_NAMESPACE_BEGIN
     return postOp == PostOp::None;
   }
 
+  bool Engine::isConvChainSupported(const std::vector<ConvDesc>& convDescs)
+  {
+    return false;
+  }
+
+  Ref<ConvChain> Engine::newConvChain(const std::vector<ConvDesc>& convDescs)
+  {
+    throw std::logic_error("convolution chain is not supported by the device");
+  }
+
   void* Engine::usmAlloc(size_t byteSize, Storage storage)
   {
     throw std::logic_error("USM is not supported by the device");
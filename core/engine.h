@@ -9,7 +9,9 @@
 #include "heap.h"
 #include "buffer.h"
 #include "image.h"
+#include "op.h"
 #include <functional>
+#include <vector>
 
 OIDN_NAMESPACE_BEGIN
 
@@ -22,6 +24,7 @@ OIDN_NAMESPACE_BEGIN
 
   enum class PostOp;
   class Conv;
+  class ConvChain;
   class ConcatConv;
   class Pool;
   class Upsample;
@@ -67,6 +70,8 @@ OIDN_NAMESPACE_BEGIN
     // Ops
     virtual bool isConvSupported(PostOp postOp);
     virtual Ref<Conv> newConv(const ConvDesc& desc) = 0;
+    virtual bool isConvChainSupported(const std::vector<ConvDesc>& convDescs);
+    virtual Ref<ConvChain> newConvChain(const std::vector<ConvDesc>& convDescs);
     virtual Ref<Pool> newPool(const PoolDesc& desc) = 0;
     virtual Ref<Upsample> newUpsample(const UpsampleDesc& desc) = 0;
     virtual Ref<Autoexposure> newAutoexposure(const ImageDesc& srcDesc) = 0;
@@ -86,9 +91,51 @@ OIDN_NAMESPACE_BEGIN
       f();
     }
 
+    // Returns the maximum number of independent host tasks which can efficiently run concurrently
+    virtual int getMaxConcurrentHostTasks() const { return 1; }
+
+    // Runs independent host tasks concurrently, each using a subset of the engine resources, and
+    // waits for all of them to complete (blocks)
+    virtual void runConcurrentHostTasks(int numTasks, const std::function<void(int)>& f)
+    {
+      for (int i = 0; i < numTasks; ++i)
+        f(i);
+    }
+
+    // Returns whether independent host tasks can be overlapped, sharing all engine resources
+    virtual bool canOverlapHostTasks() const { return false; }
+
+    // Runs two independent host tasks, overlapping them if supported, and waits for both of them
+    // to complete (blocks)
+    virtual void runOverlappedHostTasks(const std::function<void()>& f1, const std::function<void()>& f2)
+    {
+      f1();
+      f2();
+    }
+
+    // Returns whether the engine can schedule the operations of a graph at a finer granularity than
+    // whole operations, respecting the specified dependencies between them
+    virtual bool isDataflowSupported() const { return false; }
+
+    // Submits a sequence of operations, where the dependencies of each operation refer to the
+    // operations in the same sequence
+    virtual void submitDataflow(const std::vector<Ref<Op>>& ops, const std::vector<std::vector<OpDep>>& opDeps)
+    {
+      for (const auto& op : ops)
+        op->submit();
+    }
+
     // Enqueues a host function
     virtual void submitHostFunc(std::function<void()>&& f) = 0;
 
+    // Cancels the previously submitted commands which have not started executing yet, if supported
+    // by the engine (can be called from a host function)
+    virtual void cancelSubmitted() {}
+
+    // Saves the results of tuning the operations while finalizing them to persistent storage, if
+    // supported by the engine
+    virtual void saveTuning() {}
+
     // Issues all previously submitted commands (does not block)
     virtual void flush() {}
 
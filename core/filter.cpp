@@ -11,6 +11,7 @@ OIDN_NAMESPACE_BEGIN
   Filter::~Filter()
   {
     // We trim the scratch heaps only here to make filter resolution changes more efficient
+    device->removeFilterMemoryUsage(this);
     device->trimScratch();
   }
 
@@ -38,6 +39,12 @@ OIDN_NAMESPACE_BEGIN
     dst = src;
   }
 
+  void Filter::setParam(std::string& dst, const std::string& src)
+  {
+    dirtyParam |= dst != src;
+    dst = src;
+  }
+
   void Filter::setParam(Ref<Image>& dst, const Ref<Image>& src)
   {
     // Check whether the image is accessible by the device
@@ -22,10 +22,13 @@ OIDN_NAMESPACE_BEGIN
     virtual void setData(const std::string& name, const Data& data) = 0;
     virtual void updateData(const std::string& name) = 0;
     virtual void unsetData(const std::string& name) = 0;
+    virtual Data getData(const std::string& name) = 0;
     virtual void setInt(const std::string& name, int value) = 0;
     virtual int getInt(const std::string& name) = 0;
     virtual void setFloat(const std::string& name, float value) = 0;
     virtual float getFloat(const std::string& name) = 0;
+    virtual void setString(const std::string& name, const std::string& value) = 0;
+    virtual const char* getString(const std::string& name) = 0;
 
     void setProgressMonitorFunction(ProgressMonitorFunction func, void* userPtr);
 
@@ -36,6 +39,7 @@ OIDN_NAMESPACE_BEGIN
     void setParam(int& dst, int src);
     void setParam(bool& dst, int src);
     void setParam(Quality& dst, Quality src);
+    void setParam(std::string& dst, const std::string& src);
     void setParam(Ref<Image>& dst, const Ref<Image>& src);
     void removeParam(Ref<Image>& dst);
     void setParam(Data& dst, const Data& src);
@@ -1,36 +1,37 @@
 // Copyright 2018 Intel Corporation
 // SPDX-License-Identifier: Apache-2.0
 
-//#define OIDN_MICROBENCH 1000 // number of microbenchmark iterations
-
 #include "graph.h"
 #include "concat_conv_chw.h"
 #include "concat_conv_hwc.h"
 #include "tensor_reorder.h"
-#if defined(OIDN_MICROBENCH)
-  #include "common/timer.h"
-#endif
 
 OIDN_NAMESPACE_BEGIN
 
   Graph::Graph(Engine* engine,
                const std::shared_ptr<TensorMap>& constTensors,
                const std::shared_ptr<TensorMap>& cachedConstTensors,
-               bool fastMath)
+               bool fastMath,
+               bool quantized)
     : engine(engine),
       constTensors(constTensors),
       cachedConstTensors(cachedConstTensors),
-      fastMath(fastMath) {}
+      fastMath(fastMath),
+      quantized(quantized) {}
 
   Ref<InputProcess> Graph::addInputProcess(const std::string& name,
                                            const TensorDims& srcDims,
                                            const std::shared_ptr<TransferFunction>& transferFunc,
                                            bool hdr,
-                                           bool snorm)
+                                           bool snorm,
+                                           bool persistent)
   {
     auto op = engine->newInputProcess({srcDims, transferFunc, hdr, snorm});
     op->setName(name);
+    inputOpID = int(ops.size());
     auto dstAlloc = addOp(op, {}, op->getDstDesc());
+    if (persistent)
+      persistentAllocIDs.push_back(dstAlloc->id);
 
     lazyInits.push_back([=]()
     {
@@ -44,12 +45,16 @@ OIDN_NAMESPACE_BEGIN
                                              const Ref<Op>& srcOp,
                                              const std::shared_ptr<TransferFunction>& transferFunc,
                                              bool hdr,
-                                             bool snorm)
+                                             bool snorm,
+                                             bool persistent)
   {
     auto srcAlloc = tensorAllocs[srcOp.get()];
     auto op = engine->newOutputProcess({srcAlloc->desc, transferFunc, hdr, snorm});
     op->setName(name);
+    outputOpID = int(ops.size());
     addOp(op, {srcOp});
+    if (persistent)
+      persistentAllocIDs.push_back(srcAlloc->id);
 
     lazyInits.push_back([=]()
     {
@@ -79,34 +84,9 @@ OIDN_NAMESPACE_BEGIN
       }
     }
 
-    const std::string weightName = name + ".weight";
-    const std::string biasName   = name + ".bias";
-    Ref<Tensor> weight = (*constTensors)[weightName];
-    Ref<Tensor> bias   = (*constTensors)[biasName];
-
-    if (weight->getRank() != 4 || bias->getRank() != 1)
-      throw std::invalid_argument("invalid convolution weight/bias");
-
-    Device* device = engine->getDevice();
-    const int blockC = device->getTensorBlockC();
-
-    TensorDims finalWeightDims{round_up(weight->getO(), blockC),
-                               round_up(weight->getI(), blockC),
-                               weight->getH(),
-                               weight->getW()};
-
-    TensorDesc finalWeightDesc = {weight->getDims(),
-                                  finalWeightDims,
-                                  device->getWeightLayout(),
-                                  device->getWeightDataType()};
-
-    TensorDesc finalBiasDesc = {bias->getDims(),
-                                {round_up(bias->getX(), blockC)},
-                                TensorLayout::x,
-                                device->getTensorDataType()};
-
     auto srcAlloc = tensorAllocs[srcOp.get()];
-    auto conv = engine->newConv({srcAlloc->desc, finalWeightDesc, finalBiasDesc, activation, postOp, fastMath});
+    const ConvDesc convDesc = getConvDesc(name, srcAlloc->desc, activation, postOp);
+    auto conv = engine->newConv(convDesc);
     conv->setName(name);
     auto dstAlloc = addOp(conv, {srcOp}, conv->getDstDesc());
 
@@ -114,33 +94,67 @@ OIDN_NAMESPACE_BEGIN
     {
       conv->setSrc(srcAlloc->tensor);
       conv->setDst(dstAlloc->tensor);
+      conv->setWeight(getFinalWeight(name, convDesc.weightDesc));
+      conv->setBias(getFinalBias(name, convDesc.biasDesc));
+      setPackedWeight(name, conv.get());
+    });
 
-      Ref<Tensor> finalWeight = getCachedConstTensor(weightName, finalWeightDesc);
-      if (!finalWeight)
-      {
-        finalWeight = makeRef<HostTensor>(finalWeightDesc);
-        reorderWeight(*weight, *finalWeight);
-        if (device->needWeightAndBiasOnDevice())
-          finalWeight = finalWeight->toDevice(engine);
-        setCachedConstTensor(weightName, finalWeight);
-      }
+    privateByteSize += convDesc.weightDesc.getByteSize() + convDesc.biasDesc.getByteSize() +
+                       conv->getPackedWeightDesc().getByteSize();
+    return conv;
+  }
+
+  Ref<Op> Graph::addConvChain(const std::vector<std::string>& names,
+                              const Ref<Op>& srcOp,
+                              Activation activation,
+                              PostOp postOp)
+  {
+    auto srcAlloc = tensorAllocs[srcOp.get()];
 
-      Ref<Tensor> finalBias = getCachedConstTensor(biasName, finalBiasDesc);
-      if (!finalBias)
+    // Get the descriptors of all convolutions in the chain
+    std::vector<ConvDesc> convDescs;
+    TensorDesc convSrcDesc = srcAlloc->desc;
+    for (size_t i = 0; i < names.size(); ++i)
+    {
+      const PostOp convPostOp = (i + 1 < names.size()) ? PostOp::None : postOp;
+      convDescs.push_back(getConvDesc(names[i], convSrcDesc, activation, convPostOp));
+
+      const TensorDesc& weightDesc = convDescs.back().weightDesc;
+      convSrcDesc = {{weightDesc.getO(), convSrcDesc.getH(), convSrcDesc.getW()},
+                     {weightDesc.getPaddedO(), convSrcDesc.getH(), convSrcDesc.getW()},
+                     convSrcDesc.layout, convSrcDesc.dataType};
+    }
+
+    if (names.size() < 2 || !engine->isConvChainSupported(convDescs))
+    {
+      // If the engine does not support executing the chain, add the convolutions separately
+      Ref<Op> op = srcOp;
+      for (size_t i = 0; i < names.size(); ++i)
+        op = addConv(names[i], op, activation, convDescs[i].postOp);
+      return op;
+    }
+
+    auto convChain = engine->newConvChain(convDescs);
+    std::string chainName = names.front();
+    for (size_t i = 1; i < names.size(); ++i)
+      chainName += "+" + names[i];
+    convChain->setName(chainName);
+    auto dstAlloc = addOp(convChain, {srcOp}, convChain->getDstDesc());
+
+    lazyInits.push_back([=]()
+    {
+      convChain->setSrc(srcAlloc->tensor);
+      convChain->setDst(dstAlloc->tensor);
+      for (size_t i = 0; i < names.size(); ++i)
       {
-        finalBias = makeRef<HostTensor>(finalBiasDesc);
-        reorderBias(*bias, *finalBias);
-        if (device->needWeightAndBiasOnDevice())
-          finalBias = finalBias->toDevice(engine);
-        setCachedConstTensor(biasName, finalBias);
+        convChain->setWeight(int(i), getFinalWeight(names[i], convDescs[i].weightDesc));
+        convChain->setBias(int(i), getFinalBias(names[i], convDescs[i].biasDesc));
       }
-
-      conv->setWeight(finalWeight);
-      conv->setBias(finalBias);
     });
 
-    privateByteSize += finalWeightDesc.getByteSize() + finalBiasDesc.getByteSize();
-    return conv;
+    for (const auto& convDesc : convDescs)
+      privateByteSize += convDesc.weightDesc.getByteSize() + convDesc.biasDesc.getByteSize();
+    return convChain;
   }
 
   Ref<Op> Graph::addConcatConv(const std::string& name,
@@ -179,7 +193,8 @@ OIDN_NAMESPACE_BEGIN
                                 TensorLayout::x,
                                 device->getTensorDataType()};
 
-    ConcatConvDesc concatConvDesc{src1Desc, src2Desc, finalWeightDesc, finalBiasDesc, activation, fastMath};
+    ConcatConvDesc concatConvDesc{src1Desc, src2Desc, finalWeightDesc, finalBiasDesc, activation, fastMath,
+                                  getSrcScale(name)};
 
     if (device->getTensorLayout() == TensorLayout::hwc)
     {
@@ -275,9 +290,11 @@ OIDN_NAMESPACE_BEGIN
 
         concatConv->setWeight(finalWeight);
         concatConv->setBias(finalBias);
+        setPackedWeight(name, concatConv->getConv());
       });
 
-      privateByteSize += finalWeightDesc.getByteSize() + finalBiasDesc.getByteSize();
+      privateByteSize += finalWeightDesc.getByteSize() + finalBiasDesc.getByteSize() +
+                         concatConv->getConv()->getPackedWeightDesc().getByteSize();
       return concatConv;
     }
   }
@@ -327,9 +344,16 @@ OIDN_NAMESPACE_BEGIN
 
     // Add the source tensor allocations as dependencies for the operation
     std::vector<int> srcAllocIDs;
+    std::vector<int> srcOpIDs;
     for (const auto& srcOp : srcOps)
+    {
       srcAllocIDs.push_back(tensorAllocs[srcOp.get()]->id);
+      srcOpIDs.push_back(int(std::find(ops.begin(), ops.end(), srcOp) - ops.begin()));
+      if (inputOpID >= 0 && srcOp == ops[inputOpID])
+        lastInputUseOpID = opID;
+    }
     tensorScratchPlanner.addDepAllocs(opID, srcAllocIDs, concatSrcs);
+    opSrcIDs.push_back(srcOpIDs);
 
     ops.push_back(op);
     dirty = true;
@@ -356,6 +380,8 @@ OIDN_NAMESPACE_BEGIN
 
   void Graph::planAllocs()
   {
+    tensorScratchPlanner.addPersistentAllocs(persistentAllocIDs);
+
     tensorScratchPlanner.commit();
 
     // Compute the size of the operation scratch
@@ -406,10 +432,58 @@ OIDN_NAMESPACE_BEGIN
     this->scratch = scratch;
   }
 
+  void Graph::planOpDeps()
+  {
+    // Get the memory ranges of the destinations in the tensor scratch
+    std::vector<std::pair<size_t, size_t>> dstRanges(ops.size(), {0, 0});
+    for (size_t i = 0; i < ops.size(); ++i)
+    {
+      auto allocIter = tensorAllocs.find(ops[i].get());
+      if (allocIter != tensorAllocs.end())
+      {
+        const size_t byteOffset = tensorScratchPlanner.getAllocByteOffset(allocIter->second->id);
+        dstRanges[i] = {byteOffset, byteOffset + allocIter->second->desc.getByteSize()};
+      }
+    }
+
+    auto overlaps = [&](int i, int j)
+    {
+      return dstRanges[i].first < dstRanges[j].second && dstRanges[j].first < dstRanges[i].second;
+    };
+
+    opDeps.clear();
+    opDeps.resize(ops.size());
+
+    for (int i = 0; i < int(ops.size()); ++i)
+    {
+      // The operation depends only on the rows of its sources it reads
+      for (int srcOpID : opSrcIDs[i])
+        opDeps[i].push_back({srcOpID, true});
+
+      // The destination may reuse the memory of tensors accessed by previous operations, and the
+      // operation scratch is shared by all operations, so these must be completed first
+      const bool hasScratch = ops[i]->getScratchByteSize() > 0;
+      for (int j = 0; j < i; ++j)
+      {
+        if (std::find(opSrcIDs[i].begin(), opSrcIDs[i].end(), j) != opSrcIDs[i].end())
+          continue;
+
+        bool conflict = (hasScratch && ops[j]->getScratchByteSize() > 0) || overlaps(i, j);
+        for (int srcOpID : opSrcIDs[j])
+          conflict = conflict || overlaps(i, srcOpID);
+
+        if (conflict)
+          opDeps[i].push_back({j, false});
+      }
+    }
+  }
+
   void Graph::cleanup()
   {
     lazyInits.clear();
     tensorAllocs.clear();
+    opSrcIDs.clear();
+    persistentAllocIDs.clear();
     tensorScratchPlanner.clear();
   }
 
@@ -420,10 +494,14 @@ OIDN_NAMESPACE_BEGIN
 
     cleanup();
     ops.clear();
+    opDeps.clear();
     scratch.reset();
     scratchByteSize = 0;
     privateByteSize = 0;
     tensorScratchByteOffset = 0;
+    inputOpID = -1;
+    lastInputUseOpID = -1;
+    outputOpID = -1;
     dirty = false;
   }
 
@@ -448,6 +526,9 @@ OIDN_NAMESPACE_BEGIN
       op->finalize();
     }
 
+    if (engine->isDataflowSupported())
+      planOpDeps();
+
     cleanup();
     constTensors.reset();
     cachedConstTensors.reset();
@@ -455,32 +536,69 @@ OIDN_NAMESPACE_BEGIN
     finalized = true;
   }
 
-  void Graph::run(Progress& progress)
+  void Graph::run(Progress& progress, Profiler* profiler, int profilerThreadID)
   {
     if (!finalized)
       throw std::logic_error("graph not finalized");
 
-  #if defined(OIDN_MICROBENCH)
-    double totalTime = 0;
-    std::cerr << std::endl;
-    std::cerr << "op,name,msec" << std::endl;
-  #endif
+    runOps(0, int(ops.size()), progress, profiler, profilerThreadID);
+  }
 
-    for (size_t i = 0; i < ops.size(); ++i)
+  void Graph::run(GraphStage stage, Progress& progress, Profiler* profiler, int profilerThreadID)
+  {
+    if (!finalized)
+      throw std::logic_error("graph not finalized");
+    if (inputOpID != 0 || outputOpID != int(ops.size()) - 1 || lastInputUseOpID >= outputOpID)
+      throw std::logic_error("graph cannot be run in stages");
+
+    switch (stage)
     {
-      ops[i]->submit();
+    case GraphStage::Input:
+      runOps(inputOpID, inputOpID + 1, progress, profiler, profilerThreadID);
+      break;
+    case GraphStage::Head:
+      runOps(inputOpID + 1, lastInputUseOpID + 1, progress, profiler, profilerThreadID);
+      break;
+    case GraphStage::Tail:
+      runOps(lastInputUseOpID + 1, outputOpID, progress, profiler, profilerThreadID);
+      break;
+    case GraphStage::Output:
+      runOps(outputOpID, outputOpID + 1, progress, profiler, profilerThreadID);
+      break;
+    }
+  }
 
-    #if defined(OIDN_MICROBENCH)
-      engine->wait();
-      const int numRuns = OIDN_MICROBENCH;
-      Timer timer;
-      for (int j = 0; j < numRuns; ++j)
+  void Graph::runOps(int beginOpID, int endOpID, Progress& progress, Profiler* profiler, int profilerThreadID)
+  {
+    if (beginOpID >= endOpID)
+      return;
+
+    if (!profiler && engine->isDataflowSupported())
+    {
+      // Submit all operations at once, which allows the engine to overlap them where the
+      // dependencies permit (the operations before the range have been already submitted)
+      std::vector<Ref<Op>> rangeOps(ops.begin() + beginOpID, ops.begin() + endOpID);
+      std::vector<std::vector<OpDep>> rangeOpDeps(endOpID - beginOpID);
+      for (int i = beginOpID; i < endOpID; ++i)
+      {
+        for (const auto& dep : opDeps[i])
+        {
+          if (dep.opIndex >= beginOpID)
+            rangeOpDeps[i - beginOpID].push_back({dep.opIndex - beginOpID, dep.rowwise});
+        }
+      }
+
+      engine->submitDataflow(rangeOps, rangeOpDeps);
+      progress.update(engine, endOpID - beginOpID);
+      return;
+    }
+
+    for (int i = beginOpID; i < endOpID; ++i)
+    {
+      if (profiler)
+        profiler->run(engine, *ops[i], profilerThreadID);
+      else
         ops[i]->submit();
-      engine->wait();
-      const double time = timer.query() / numRuns;
-      std::cerr << i << "," << ops[i]->getName() << "," << time * 1000 << std::endl;
-      totalTime += time;
-    #endif
 
     #if 0
       // Dump
@@ -508,10 +626,107 @@ OIDN_NAMESPACE_BEGIN
 
       progress.update(engine, 1);
     }
+  }
 
-  #if defined(OIDN_MICROBENCH)
-    std::cerr << ",total," << totalTime * 1000 << std::endl;
-  #endif
+  ConvDesc Graph::getConvDesc(const std::string& name, const TensorDesc& srcDesc,
+                              Activation activation, PostOp postOp)
+  {
+    Ref<Tensor> weight = (*constTensors)[name + ".weight"];
+    Ref<Tensor> bias   = (*constTensors)[name + ".bias"];
+
+    if (weight->getRank() != 4 || bias->getRank() != 1)
+      throw std::invalid_argument("invalid convolution weight/bias");
+
+    Device* device = engine->getDevice();
+    const int blockC = device->getTensorBlockC();
+
+    TensorDims finalWeightDims{round_up(weight->getO(), blockC),
+                               round_up(weight->getI(), blockC),
+                               weight->getH(),
+                               weight->getW()};
+
+    TensorDesc finalWeightDesc = {weight->getDims(),
+                                  finalWeightDims,
+                                  device->getWeightLayout(),
+                                  device->getWeightDataType()};
+
+    TensorDesc finalBiasDesc = {bias->getDims(),
+                                {round_up(bias->getX(), blockC)},
+                                TensorLayout::x,
+                                device->getTensorDataType()};
+
+    return {srcDesc, finalWeightDesc, finalBiasDesc, activation, postOp, fastMath, getSrcScale(name)};
+  }
+
+  float Graph::getSrcScale(const std::string& name)
+  {
+    if (!quantized)
+      return 0.f;
+
+    // The scale is stored in the weights only if the source of the convolution has been calibrated
+    auto scaleIter = constTensors->find(name + ".input_scale");
+    if (scaleIter == constTensors->end())
+      return 0.f;
+
+    const Ref<Tensor>& scale = scaleIter->second;
+    if (scale->getRank() != 1 || scale->getX() != 1 || scale->getDataType() != DataType::Float32)
+      throw std::invalid_argument("invalid convolution input scale");
+
+    const float value = *static_cast<const float*>(scale->getPtr());
+    return (std::isfinite(value) && value > 0.f) ? value : 0.f;
+  }
+
+  Ref<Tensor> Graph::getFinalWeight(const std::string& name, const TensorDesc& finalWeightDesc)
+  {
+    const std::string weightName = name + ".weight";
+    Ref<Tensor> finalWeight = getCachedConstTensor(weightName, finalWeightDesc);
+    if (!finalWeight)
+    {
+      Device* device = engine->getDevice();
+      finalWeight = makeRef<HostTensor>(finalWeightDesc);
+      reorderWeight(*(*constTensors)[weightName], *finalWeight);
+      if (device->needWeightAndBiasOnDevice())
+        finalWeight = finalWeight->toDevice(engine);
+      setCachedConstTensor(weightName, finalWeight);
+    }
+    return finalWeight;
+  }
+
+  Ref<Tensor> Graph::getFinalBias(const std::string& name, const TensorDesc& finalBiasDesc)
+  {
+    const std::string biasName = name + ".bias";
+    Ref<Tensor> finalBias = getCachedConstTensor(biasName, finalBiasDesc);
+    if (!finalBias)
+    {
+      Device* device = engine->getDevice();
+      finalBias = makeRef<HostTensor>(finalBiasDesc);
+      reorderBias(*(*constTensors)[biasName], *finalBias);
+      if (device->needWeightAndBiasOnDevice())
+        finalBias = finalBias->toDevice(engine);
+      setCachedConstTensor(biasName, finalBias);
+    }
+    return finalBias;
+  }
+
+  // Sets the packed weight of a convolution if required, which is cached like the final weights
+  void Graph::setPackedWeight(const std::string& name, Conv* conv)
+  {
+    const TensorDesc packedWeightDesc = conv->getPackedWeightDesc();
+    if (packedWeightDesc.getRank() == 0)
+      return; // the convolution uses the final weight directly
+
+    const std::string packedWeightName = name + conv->getPackedWeightSuffix();
+    Ref<Tensor> packedWeight = getCachedConstTensor(packedWeightName, packedWeightDesc);
+    if (!packedWeight)
+    {
+      Device* device = engine->getDevice();
+      packedWeight = makeRef<HostTensor>(packedWeightDesc);
+      conv->packWeight(*packedWeight);
+      if (device->needWeightAndBiasOnDevice())
+        packedWeight = packedWeight->toDevice(engine);
+      setCachedConstTensor(packedWeightName, packedWeight);
+    }
+    conv->setPackedWeight(packedWeight);
   }
 
   Ref<Tensor> Graph::getCachedConstTensor(const std::string& name, const TensorDesc& desc)
@@ -4,41 +4,66 @@
 #include "input_process.h"
 #include "output_process.h"
 #include "conv.h"
+#include "conv_chain.h"
 #include "concat_conv.h"
 #include "pool.h"
 #include "upsample.h"
 #include "progress.h"
+#include "profiler.h"
 #include "arena_planner.h"
 #include <vector>
 #include <unordered_map>
 
 OIDN_NAMESPACE_BEGIN
 
+  // Stages of the graph which can be run separately, making it possible to overlap the input and
+  // output processing of a run with the convolutions of the adjacent runs (pipelining)
+  enum class GraphStage
+  {
+    Input,  // input process
+    Head,   // operations up to the last one using the input
+    Tail,   // remaining operations before the output process
+    Output  // output process
+  };
+
   class Graph final : public RefCount
   {
   public:
     Graph(Engine* engine,
           const std::shared_ptr<TensorMap>& constTensors,
           const std::shared_ptr<TensorMap>& cachedConstTensors,
-          bool fastMath = false);
+          bool fastMath = false,
+          bool quantized = false);
 
+    // If persistent is enabled, the destination tensor is not overwritten by other operations,
+    // thus its contents are preserved between runs of the graph
     Ref<InputProcess> addInputProcess(const std::string& name,
                                       const TensorDims& srcDims,
                                       const std::shared_ptr<TransferFunction>& transferFunc,
                                       bool hdr,
-                                      bool snorm);
+                                      bool snorm,
+                                      bool persistent = false);
 
+    // If persistent is enabled, the source tensor is not overwritten by other operations
     Ref<OutputProcess> addOutputProcess(const std::string& name,
                                         const Ref<Op>& srcOp,
                                         const std::shared_ptr<TransferFunction>& transferFunc,
                                         bool hdr,
-                                        bool snorm);
+                                        bool snorm,
+                                        bool persistent = false);
 
     Ref<Op> addConv(const std::string& name,
                     const Ref<Op>& srcOp,
                     Activation activation,
                     PostOp postOp = PostOp::None);
 
+    // Adds consecutive convolutions with the same activation, where only the last one may have a
+    // post-op, which may be executed as a chain to avoid storing the intermediate outputs
+    Ref<Op> addConvChain(const std::vector<std::string>& names,
+                         const Ref<Op>& srcOp,
+                         Activation activation,
+                         PostOp postOp = PostOp::None);
+
     Ref<Op> addConcatConv(const std::string& name,
                           const Ref<Op>& src1Op,
                           const Ref<Op>& src2Op,
@@ -59,7 +84,12 @@ OIDN_NAMESPACE_BEGIN
     double getWorkAmount() const;
     void clear();
     void finalize();
-    void run(Progress& progress);
+    void run(Progress& progress, Profiler* profiler = nullptr, int profilerThreadID = 0);
+
+    // Runs only the specified stage of the graph
+    // The Input and Output stages may run concurrently with the Tail and Head stages of other runs,
+    // respectively, only if the input process destination and output process source are persistent
+    void run(GraphStage stage, Progress& progress, Profiler* profiler = nullptr, int profilerThreadID = 0);
 
   private:
     // Temporary tensor allocation
@@ -85,27 +115,45 @@ OIDN_NAMESPACE_BEGIN
                                        bool concatSrcs = false);
 
     void planAllocs();
+    void planOpDeps();
     void cleanup();
+    void runOps(int beginOpID, int endOpID, Progress& progress, Profiler* profiler, int profilerThreadID);
+
+    ConvDesc getConvDesc(const std::string& name, const TensorDesc& srcDesc,
+                         Activation activation, PostOp postOp);
+    float getSrcScale(const std::string& name);
+    Ref<Tensor> getFinalWeight(const std::string& name, const TensorDesc& finalWeightDesc);
+    Ref<Tensor> getFinalBias(const std::string& name, const TensorDesc& finalBiasDesc);
+    void setPackedWeight(const std::string& name, Conv* conv);
 
     Ref<Tensor> getCachedConstTensor(const std::string& name, const TensorDesc& desc);
     void setCachedConstTensor(const std::string& name, const Ref<Tensor>& tensor);
 
     Engine* engine;
     std::vector<Ref<Op>> ops;
+    std::vector<std::vector<OpDep>> opDeps; // dependencies of the operations for dataflow execution
     Ref<Buffer> scratch;        // scratch buffer
     size_t scratchByteSize = 0; // total size of scratch data
     size_t privateByteSize = 0; // total size of private data (e.g. constant tensors)
     bool dirty = false;
     bool finalized = false;
 
+    // Operations delimiting the stages of the graph
+    int inputOpID = -1;        // input process
+    int lastInputUseOpID = -1; // last operation using the destination of the input process
+    int outputOpID = -1;       // output process
+
     // Used only while building the graph
     ArenaPlanner tensorScratchPlanner;  // tensor scratch allocation planner
     size_t tensorScratchByteOffset = 0; // offset of tensor data in the scratch buffer
     std::unordered_map<Op*, std::shared_ptr<TensorAlloc>> tensorAllocs;
+    std::vector<std::vector<int>> opSrcIDs; // source operations of each operation
+    std::vector<int> persistentAllocIDs; // allocations which must live during the whole graph
     std::vector<std::function<void()>> lazyInits;  // lazy initialization for ops
     std::shared_ptr<TensorMap> constTensors;       // original weights
     std::shared_ptr<TensorMap> cachedConstTensors; // cached final weights shared with other graphs
     bool fastMath = false;
+    bool quantized = false; // use the calibrated INT8 quantization scales if available
   };
 
 OIDN_NAMESPACE_END
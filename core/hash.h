@@ -0,0 +1,23 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "common/common.h"
+
+OIDN_NAMESPACE_BEGIN
+
+  // Computes the 64-bit FNV-1a hash of a memory block
+  inline uint64_t hashBytes(const void* ptr, size_t byteSize)
+  {
+    const uint8_t* bytes = static_cast<const uint8_t*>(ptr);
+    uint64_t hash = 0xcbf29ce484222325;
+    for (size_t i = 0; i < byteSize; ++i)
+    {
+      hash ^= bytes[i];
+      hash *= 0x100000001b3;
+    }
+    return hash;
+  }
+
+OIDN_NAMESPACE_END
@@ -80,6 +80,30 @@ OIDN_NAMESPACE_BEGIN
       ptr = static_cast<char*>(buffer->getPtr()) + byteOffset;
   }
 
+  Ref<Image> Image::newRows(size_t hBegin, size_t numRows) const
+  {
+    if (hBegin + numRows > height)
+      throw std::out_of_range("image rows out of bounds");
+
+    const size_t rowsByteOffset = hBegin * hByteStride;
+    if (buffer)
+      return makeRef<Image>(buffer, format, width, numRows, byteOffset + rowsByteOffset, wByteStride, hByteStride);
+    else
+      return makeRef<Image>(ptr, format, width, numRows, rowsByteOffset, wByteStride, hByteStride);
+  }
+
+  Ref<Image> Image::newRegion(size_t hBegin, size_t wBegin, size_t numRows, size_t numCols) const
+  {
+    if (hBegin + numRows > height || wBegin + numCols > width)
+      throw std::out_of_range("image region out of bounds");
+
+    const size_t regionByteOffset = hBegin * hByteStride + wBegin * wByteStride;
+    if (buffer)
+      return makeRef<Image>(buffer, format, numCols, numRows, byteOffset + regionByteOffset, wByteStride, hByteStride);
+    else
+      return makeRef<Image>(ptr, format, numCols, numRows, regionByteOffset, wByteStride, hByteStride);
+  }
+
   bool Image::overlaps(const Image& other) const
   {
     if (!*this || !other)
@@ -115,6 +115,12 @@ OIDN_NAMESPACE_BEGIN
     // Determines whether two images overlap in memory
     bool overlaps(const Image& other) const;
 
+    // Returns a new image referencing a range of rows of the image
+    Ref<Image> newRows(size_t hBegin, size_t numRows) const;
+
+    // Returns a new image referencing a rectangular region of the image
+    Ref<Image> newRegion(size_t hBegin, size_t wBegin, size_t numRows, size_t numCols) const;
+
   private:
     char* ptr; // pointer to the first pixel
   };
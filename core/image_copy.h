@@ -14,6 +14,8 @@ OIDN_NAMESPACE_BEGIN
     void setSrc(const Ref<Image>& src) { this->src = src; }
     void setDst(const Ref<Image>& dst) { this->dst = dst; }
 
+    size_t getNumBytes() const override { return src ? 2 * src->getByteSize() : 0; }
+
   protected:
     void check()
     {
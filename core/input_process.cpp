@@ -50,7 +50,8 @@ OIDN_NAMESPACE_BEGIN
     this->dst = dst;
   }
 
-  void InputProcess::setTile(int hSrc, int wSrc, int hDst, int wDst, int H, int W)
+  void InputProcess::setTile(int hSrc, int wSrc, int hDst, int wDst, int H, int W,
+                             int B, int hSrcStride, int hDstStride)
   {
     tile.hSrcBegin = hSrc;
     tile.wSrcBegin = wSrc;
@@ -58,17 +59,39 @@ OIDN_NAMESPACE_BEGIN
     tile.wDstBegin = wDst;
     tile.H = H;
     tile.W = W;
+    tile.B = B;
+    tile.hSrcStride = hSrcStride;
+    tile.hDstStride = hDstStride;
   }
 
   void InputProcess::check()
   {
     if (!getMainSrc() || !dst)
       throw std::logic_error("input processing source/destination not set");
-    if (tile.hSrcBegin + tile.H > getMainSrc()->getH() ||
+    if (tile.B < 1 || (tile.B > 1 && (tile.hSrcStride < tile.H || tile.hDstStride < tile.H)))
+      throw std::logic_error("invalid input processing tile");
+
+    // Rows of the last image in the tile
+    const int hSrcEnd = tile.hSrcBegin + (tile.B - 1) * tile.hSrcStride + tile.H;
+    const int hDstEnd = tile.hDstBegin + (tile.B - 1) * tile.hDstStride + tile.H;
+
+    if (hSrcEnd > getMainSrc()->getH() ||
         tile.wSrcBegin + tile.W > getMainSrc()->getW() ||
-        tile.hDstBegin + tile.H > dst->getH() ||
+        hDstEnd > dst->getH() ||
         tile.wDstBegin + tile.W > dst->getW())
       throw std::out_of_range("input processing source/destination out of bounds");
   }
 
+  size_t InputProcess::getNumBytes() const
+  {
+    size_t srcPixelByteSize = 0;
+    for (const Image* src : {color.get(), albedo.get(), normal.get()})
+    {
+      if (src && (!keepAux || src == color.get()))
+        srcPixelByteSize += getFormatSize(src->getFormat());
+    }
+
+    return size_t(tile.B) * tile.H * tile.W * srcPixelByteSize + dstDesc.getByteSize();
+  }
+
 OIDN_NAMESPACE_END
\ No newline at end of file
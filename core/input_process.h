@@ -31,7 +31,14 @@ OIDN_NAMESPACE_BEGIN
                 const Ref<Image>& albedo,
                 const Ref<Image>& normal);
     void setDst(const Ref<Tensor>& dst);
-    void setTile(int hSrc, int wSrc, int hDst, int wDst, int H, int W);
+    void setTile(int hSrc, int wSrc, int hDst, int wDst, int H, int W,
+                 int B = 1, int hSrcStride = 0, int hDstStride = 0);
+
+    // If enabled, only the main input is processed and the auxiliary features already stored in
+    // the destination by a previous execution are kept (the destination must be persistent)
+    void setKeepAux(bool keepAux) { this->keepAux = keepAux; }
+
+    size_t getNumBytes() const override;
 
   protected:
     virtual void updateSrc() {}
@@ -48,6 +55,7 @@ OIDN_NAMESPACE_BEGIN
     Ref<Image> normal;
     Ref<Tensor> dst;
     Tile tile;
+    bool keepAux = false;
   };
 
 OIDN_NAMESPACE_END
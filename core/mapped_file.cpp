@@ -0,0 +1,118 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "mapped_file.h"
+#if !defined(_WIN32)
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <fcntl.h>
+  #include <unistd.h>
+#endif
+
+OIDN_NAMESPACE_BEGIN
+
+#if defined(_WIN32)
+
+  MappedFile::MappedFile(const std::string& filename)
+  {
+    fileHandle = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE,
+                             nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE)
+      throw std::runtime_error("cannot open file: " + filename);
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0)
+    {
+      CloseHandle(fileHandle);
+      throw std::runtime_error("cannot map empty file: " + filename);
+    }
+    byteSize = size_t(fileSize.QuadPart);
+
+    mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mappingHandle)
+      ptr = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+
+    if (!ptr)
+    {
+      if (mappingHandle)
+        CloseHandle(mappingHandle);
+      CloseHandle(fileHandle);
+      throw std::runtime_error("cannot map file: " + filename);
+    }
+  }
+
+  MappedFile::~MappedFile()
+  {
+    UnmapViewOfFile(ptr);
+    CloseHandle(mappingHandle);
+    CloseHandle(fileHandle);
+  }
+
+  std::string MappedFile::getFileID(const std::string& filename)
+  {
+    HANDLE handle = CreateFileA(filename.c_str(), 0, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE)
+      return "";
+
+    BY_HANDLE_FILE_INFORMATION info;
+    const bool success = GetFileInformationByHandle(handle, &info);
+    CloseHandle(handle);
+    if (!success)
+      return "";
+
+    return toString(info.dwVolumeSerialNumber) + ":" +
+           toString(info.nFileIndexHigh) + ":" + toString(info.nFileIndexLow) + ":" +
+           toString(info.nFileSizeHigh) + ":" + toString(info.nFileSizeLow) + ":" +
+           toString(info.ftLastWriteTime.dwHighDateTime) + ":" +
+           toString(info.ftLastWriteTime.dwLowDateTime);
+  }
+
+#else
+
+  MappedFile::MappedFile(const std::string& filename)
+  {
+    const int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+      throw std::runtime_error("cannot open file: " + filename);
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0 || fileStat.st_size == 0)
+    {
+      close(fd);
+      throw std::runtime_error("cannot map empty file: " + filename);
+    }
+    byteSize = size_t(fileStat.st_size);
+
+    // The mapping remains valid after closing the file descriptor
+    ptr = mmap(nullptr, byteSize, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (ptr == MAP_FAILED)
+      throw std::runtime_error("cannot map file: " + filename);
+  }
+
+  MappedFile::~MappedFile()
+  {
+    munmap(ptr, byteSize);
+  }
+
+  std::string MappedFile::getFileID(const std::string& filename)
+  {
+    struct stat fileStat;
+    if (stat(filename.c_str(), &fileStat) != 0)
+      return "";
+
+  #if defined(__APPLE__)
+    const struct timespec& mtime = fileStat.st_mtimespec;
+  #else
+    const struct timespec& mtime = fileStat.st_mtim;
+  #endif
+
+    return toString(uint64_t(fileStat.st_dev)) + ":" + toString(uint64_t(fileStat.st_ino)) + ":" +
+           toString(uint64_t(fileStat.st_size)) + ":" +
+           toString(int64_t(mtime.tv_sec)) + ":" + toString(int64_t(mtime.tv_nsec));
+  }
+
+#endif
+
+OIDN_NAMESPACE_END
@@ -0,0 +1,34 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "common/common.h"
+#include "ref.h"
+
+OIDN_NAMESPACE_BEGIN
+
+  // Read-only memory-mapped file
+  class MappedFile final : public RefCount
+  {
+  public:
+    explicit MappedFile(const std::string& filename);
+    ~MappedFile();
+
+    // Gets a string identifying the current version of a file (device, inode, size and modification
+    // time), or an empty string if the file is not accessible
+    static std::string getFileID(const std::string& filename);
+
+    const void* getPtr() const { return ptr; }
+    size_t getByteSize() const { return byteSize; }
+
+  private:
+    void* ptr = nullptr;
+    size_t byteSize = 0;
+  #if defined(_WIN32)
+    HANDLE fileHandle = INVALID_HANDLE_VALUE;
+    HANDLE mappingHandle = nullptr;
+  #endif
+  };
+
+OIDN_NAMESPACE_END
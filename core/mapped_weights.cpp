@@ -0,0 +1,56 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "mapped_weights.h"
+#include "exception.h"
+#include "hash.h"
+#include <mutex>
+
+OIDN_NAMESPACE_BEGIN
+
+  std::shared_ptr<MappedWeights> MappedWeights::get(const std::string& path)
+  {
+    static std::mutex mutex;
+    static std::unordered_map<std::string, std::weak_ptr<MappedWeights>> mappings;
+
+    // A modified file gets a new ID, thus it is mapped again while the old mapping is still used
+    const std::string fileID = MappedFile::getFileID(path);
+    if (fileID.empty())
+      throw Exception(Error::InvalidOperation, "cannot open weights file '" + path + "'");
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // Remove the mappings which are not used anymore
+    for (auto it = mappings.begin(); it != mappings.end(); )
+    {
+      if (it->second.expired())
+        it = mappings.erase(it);
+      else
+        ++it;
+    }
+
+    std::shared_ptr<MappedWeights> weights = mappings[fileID].lock();
+    if (!weights)
+    {
+      weights = std::make_shared<MappedWeights>(path);
+      mappings[fileID] = weights;
+    }
+    return weights;
+  }
+
+  MappedWeights::MappedWeights(const std::string& path)
+  {
+    try
+    {
+      file = makeRef<MappedFile>(path);
+    }
+    catch (const std::exception&)
+    {
+      throw Exception(Error::InvalidOperation, "cannot open weights file '" + path + "'");
+    }
+
+    tensors = parseTZA(file->getPtr(), file->getByteSize(), &metadata);
+    hash = hashBytes(file->getPtr(), file->getByteSize());
+  }
+
+OIDN_NAMESPACE_END
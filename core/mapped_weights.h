@@ -0,0 +1,36 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "mapped_file.h"
+#include "tza.h"
+#include "data.h"
+
+OIDN_NAMESPACE_BEGIN
+
+  // Weights file mapped into memory read-only and parsed without copying. The mappings are shared
+  // process-wide by all filters using the same version of a file (identified by the device, inode,
+  // size and modification time), so the weights are stored in host memory only once and are parsed
+  // and hashed only once as well.
+  class MappedWeights final
+  {
+  public:
+    // Gets the shared mapping of a weights file, mapping it if it is not mapped yet
+    static std::shared_ptr<MappedWeights> get(const std::string& path);
+
+    explicit MappedWeights(const std::string& path);
+
+    Data getBlob() const { return {file->getPtr(), file->getByteSize()}; }
+    const std::shared_ptr<TensorMap>& getTensors() const { return tensors; }
+    const TZAMetadata& getMetadata() const { return metadata; }
+    uint64_t getHash() const { return hash; } // hash of the file contents
+
+  private:
+    Ref<MappedFile> file;
+    std::shared_ptr<TensorMap> tensors; // tensors referencing the mapped memory
+    TZAMetadata metadata;
+    uint64_t hash;
+  };
+
+OIDN_NAMESPACE_END
@@ -0,0 +1,162 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "network_topology.h"
+#include "exception.h"
+#include <unordered_map>
+
+OIDN_NAMESPACE_BEGIN
+
+  namespace
+  {
+    void throwInvalidTopology(const std::string& line)
+    {
+      throw Exception(Error::InvalidOperation, "invalid network topology in weights blob: '" + line + "'");
+    }
+  }
+
+  NetworkTopology::NetworkTopology(const std::string& str)
+  {
+    std::unordered_map<std::string, int> levels; // output levels of the already parsed layers
+    levels["input"] = 0;
+
+    std::istringstream stream(str);
+    std::string line;
+    while (std::getline(stream, line))
+    {
+      std::istringstream lineStream(line);
+      std::string name, src, skip, activation, postOp, extra;
+      if (!(lineStream >> name))
+        continue; // empty line
+      if (!(lineStream >> src >> skip >> activation >> postOp) || (lineStream >> extra))
+        throwInvalidTopology(line);
+
+      Layer layer;
+      layer.name = name;
+      layer.src  = src;
+      layer.skip = (skip != "-") ? skip : "";
+
+      if (activation == "relu")
+        layer.activation = Activation::ReLU;
+      else if (activation == "-")
+        layer.activation = Activation::None;
+      else
+        throwInvalidTopology(line);
+
+      if (postOp == "pool")
+        layer.postOp = PostOp::Pool;
+      else if (postOp == "upsample")
+        layer.postOp = PostOp::Upsample;
+      else if (postOp == "-")
+        layer.postOp = PostOp::None;
+      else
+        throwInvalidTopology(line);
+
+      // The sources must be earlier layers, and the concatenated tensors must have the same resolution
+      if (levels.find(name) != levels.end() || levels.find(src) == levels.end())
+        throwInvalidTopology(line);
+      const int srcLevel = levels[src];
+      if (!layer.skip.empty() && (levels.find(layer.skip) == levels.end() || levels[layer.skip] != srcLevel))
+        throwInvalidTopology(line);
+
+      layer.level = srcLevel;
+      if (layer.postOp == PostOp::Pool)
+        ++layer.level;
+      else if (layer.postOp == PostOp::Upsample)
+        --layer.level;
+      if (layer.level < 0)
+        throwInvalidTopology(line);
+
+      levels[name] = layer.level;
+      maxLevel = max(maxLevel, layer.level);
+      layers.push_back(layer);
+    }
+
+    // The output must have the resolution of the input
+    if (layers.empty() || layers.back().level != 0)
+      throw Exception(Error::InvalidOperation, "invalid network topology in weights blob");
+  }
+
+  const NetworkTopology& NetworkTopology::getDefault()
+  {
+    static const NetworkTopology topology(
+      "enc_conv0  input      -          relu -\n"
+      "enc_conv1  enc_conv0  -          relu pool\n"
+      "enc_conv2  enc_conv1  -          relu pool\n"
+      "enc_conv3  enc_conv2  -          relu pool\n"
+      "enc_conv4  enc_conv3  -          relu pool\n"
+      "enc_conv5a enc_conv4  -          relu -\n"
+      "enc_conv5b enc_conv5a -          relu upsample\n"
+      "dec_conv4a enc_conv5b enc_conv3  relu -\n"
+      "dec_conv4b dec_conv4a -          relu upsample\n"
+      "dec_conv3a dec_conv4b enc_conv2  relu -\n"
+      "dec_conv3b dec_conv3a -          relu upsample\n"
+      "dec_conv2a dec_conv3b enc_conv1  relu -\n"
+      "dec_conv2b dec_conv2a -          relu upsample\n"
+      "dec_conv1a dec_conv2b input      relu -\n"
+      "dec_conv1b dec_conv1a -          relu -\n"
+      "dec_conv0  dec_conv1b -          relu -\n");
+    return topology;
+  }
+
+  int NetworkTopology::getReceptiveField(const TensorMap& constTensors) const
+  {
+    // Track the receptive field and the distance between adjacent pixels of each layer output,
+    // measured in input pixels
+    struct Field
+    {
+      int size;
+      int stride;
+    };
+
+    std::unordered_map<std::string, Field> fields;
+    fields["input"] = {1, 1};
+
+    for (const auto& layer : layers)
+    {
+      auto weightIter = constTensors.find(layer.name + ".weight");
+      if (weightIter == constTensors.end() || weightIter->second->getDesc().getRank() != 4)
+        throw Exception(Error::InvalidOperation, "missing or invalid weights for layer '" + layer.name + "'");
+      const TensorDesc& weightDesc = weightIter->second->getDesc();
+
+      Field field = fields[layer.src];
+      if (!layer.skip.empty())
+        field.size = max(field.size, fields[layer.skip].size);
+
+      field.size += (max(weightDesc.getH(), weightDesc.getW()) - 1) * field.stride;
+
+      if (layer.postOp == PostOp::Pool)
+      {
+        field.size += field.stride;
+        field.stride *= 2;
+      }
+      else if (layer.postOp == PostOp::Upsample)
+        field.stride /= 2;
+
+      fields[layer.name] = field;
+    }
+
+    return fields[layers.back().name].size;
+  }
+
+  bool NetworkTopology::isChainable(size_t layerIndex) const
+  {
+    if (layerIndex + 1 >= layers.size())
+      return false;
+
+    const Layer& layer = layers[layerIndex];
+    const Layer& next  = layers[layerIndex + 1];
+    if (layer.postOp != PostOp::None || next.src != layer.name || !next.skip.empty() ||
+        next.activation != layer.activation)
+      return false;
+
+    for (size_t i = layerIndex + 2; i < layers.size(); ++i)
+    {
+      if (layers[i].src == layer.name || layers[i].skip == layer.name)
+        return false;
+    }
+
+    return true;
+  }
+
+OIDN_NAMESPACE_END
@@ -0,0 +1,50 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "conv.h"
+
+OIDN_NAMESPACE_BEGIN
+
+  // Topology of a convolutional denoising network (e.g. U-Net), stored in the weights blob
+  // The network is a sequence of convolutions, each optionally followed by 2x2 max pooling or 2x
+  // nearest upsampling. A convolution may also consume the channel concatenation of its source and
+  // the output of an earlier layer (skip connection). The channel counts are defined by the weights.
+  class NetworkTopology
+  {
+  public:
+    struct Layer
+    {
+      std::string name; // name of the weight and bias tensors
+      std::string src;  // name of the source layer or 'input'
+      std::string skip; // name of the concatenated layer or 'input', empty if none
+      Activation activation;
+      PostOp postOp;
+      int level;        // downsampling level of the output (output resolution is 1/2^level)
+    };
+
+    // Parses a topology from a string, which contains a line for each layer in execution order:
+    // <name> <src> <skip or -> <relu or -> <pool, upsample or ->
+    explicit NetworkTopology(const std::string& str);
+
+    // Gets the 5-level U-Net topology of the built-in weights
+    static const NetworkTopology& getDefault();
+
+    const std::vector<Layer>& getLayers() const { return layers; }
+
+    // Gets the required spatial alignment of the input in pixels
+    int getAlignment() const { return 1 << maxLevel; }
+
+    // Computes the receptive field in pixels, using the kernel sizes of the weights
+    int getReceptiveField(const TensorMap& constTensors) const;
+
+    // Checks whether the output of a layer is consumed only by the next layer
+    bool isChainable(size_t layerIndex) const;
+
+  private:
+    std::vector<Layer> layers;
+    int maxLevel = 0;
+  };
+
+OIDN_NAMESPACE_END
@@ -7,6 +7,13 @@
 
 OIDN_NAMESPACE_BEGIN
 
+  // Dependency of an operation on a previous operation
+  struct OpDep
+  {
+    int opIndex;  // index of the operation depended on
+    bool rowwise; // only the rows of its destination used as source must be completed, not all
+  };
+
   // Abstract operation class
   class Op : public RefCount
   {
@@ -29,6 +36,10 @@ OIDN_NAMESPACE_BEGIN
       throw std::logic_error("operation is not implemented");
     }
 
+    // Estimated cost of running the operation (for profiling)
+    virtual size_t getNumBytes() const { return 0; } // amount of memory accessed
+    virtual double getNumFlops() const { return 0; } // number of floating-point operations
+
     // Name for debugging purposes
     std::string getName() const { return name; }
     void setName(const std::string& name) { this->name = name; }
@@ -30,7 +30,8 @@ OIDN_NAMESPACE_BEGIN
     this->dst = dst;
   }
 
-  void OutputProcess::setTile(int hSrc, int wSrc, int hDst, int wDst, int H, int W)
+  void OutputProcess::setTile(int hSrc, int wSrc, int hDst, int wDst, int H, int W,
+                              int B, int hSrcStride, int hDstStride)
   {
     tile.hSrcBegin = hSrc;
     tile.wSrcBegin = wSrc;
@@ -38,17 +39,33 @@ OIDN_NAMESPACE_BEGIN
     tile.wDstBegin = wDst;
     tile.H = H;
     tile.W = W;
+    tile.B = B;
+    tile.hSrcStride = hSrcStride;
+    tile.hDstStride = hDstStride;
   }
 
   void OutputProcess::check()
   {
     if (!src || !dst)
       throw std::logic_error("output processing source/destination not set");
-    if (tile.hSrcBegin + tile.H > src->getH() ||
+    if (tile.B < 1 || (tile.B > 1 && (tile.hSrcStride < tile.H || tile.hDstStride < tile.H)))
+      throw std::logic_error("invalid output processing tile");
+
+    // Rows of the last image in the tile
+    const int hSrcEnd = tile.hSrcBegin + (tile.B - 1) * tile.hSrcStride + tile.H;
+    const int hDstEnd = tile.hDstBegin + (tile.B - 1) * tile.hDstStride + tile.H;
+
+    if (hSrcEnd > src->getH() ||
         tile.wSrcBegin + tile.W > src->getW() ||
-        tile.hDstBegin + tile.H > dst->getH() ||
+        hDstEnd > dst->getH() ||
         tile.wDstBegin + tile.W > dst->getW())
       throw std::out_of_range("output processing source/destination out of bounds");
   }
 
+  size_t OutputProcess::getNumBytes() const
+  {
+    const size_t dstPixelByteSize = dst ? getFormatSize(dst->getFormat()) : 0;
+    return srcDesc.getByteSize() + size_t(tile.B) * tile.H * tile.W * dstPixelByteSize;
+  }
+
 OIDN_NAMESPACE_END
\ No newline at end of file
@@ -29,7 +29,10 @@ OIDN_NAMESPACE_BEGIN
 
     void setSrc(const Ref<Tensor>& src);
     void setDst(const Ref<Image>& dst);
-    void setTile(int hSrc, int wSrc, int hDst, int wDst, int H, int W);
+    void setTile(int hSrc, int wSrc, int hDst, int wDst, int H, int W,
+                 int B = 1, int hSrcStride = 0, int hDstStride = 0);
+
+    size_t getNumBytes() const override;
 
   protected:
     void check();
@@ -26,6 +26,9 @@ OIDN_NAMESPACE_BEGIN
     void setSrc(const Ref<Tensor>& src);
     void setDst(const Ref<Tensor>& dst);
 
+    size_t getNumBytes() const override { return srcDesc.getByteSize() + dstDesc.getByteSize(); }
+    double getNumFlops() const override { return 3. * dstDesc.getNumElements(); } // 3 max per output
+
   protected:
     virtual void updateSrc() {}
     virtual void updateDst() {}
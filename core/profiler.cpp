@@ -0,0 +1,135 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "profiler.h"
+#include "engine.h"
+#include "op.h"
+#include <iomanip>
+#include <map>
+
+OIDN_NAMESPACE_BEGIN
+
+  void Profiler::reset()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    events.clear();
+    timer.reset();
+  }
+
+  void Profiler::record(const std::string& name, const std::string& category, int threadID,
+                        double beginTime, size_t numBytes, double numFlops)
+  {
+    const double endTime = getTime();
+    std::lock_guard<std::mutex> lock(mutex);
+    events.push_back({name, category, threadID, beginTime, endTime - beginTime, numBytes, numFlops});
+  }
+
+  void Profiler::run(Engine* engine, Op& op, int threadID)
+  {
+    // Make sure that only the execution of this operation is measured
+    engine->wait();
+    const double beginTime = getTime();
+    op.submit();
+    engine->wait();
+    record(op.getName(), "op", threadID, beginTime, op.getNumBytes(), op.getNumFlops());
+  }
+
+  std::string Profiler::getChromeTrace() const
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::stringstream sm;
+    sm << std::fixed << std::setprecision(3);
+    sm << "{\"traceEvents\":[";
+
+    for (size_t i = 0; i < events.size(); ++i)
+    {
+      const Event& event = events[i];
+      if (i > 0)
+        sm << ",";
+      sm << "\n{\"name\":\"" << event.name << "\""
+         << ",\"cat\":\"" << event.category << "\""
+         << ",\"ph\":\"X\",\"pid\":0"
+         << ",\"tid\":" << event.threadID
+         << ",\"ts\":"  << event.beginTime * 1e6
+         << ",\"dur\":" << event.duration  * 1e6;
+
+      if (event.numBytes > 0 || event.numFlops > 0)
+      {
+        sm << ",\"args\":{\"bytes\":" << event.numBytes
+           << ",\"flops\":" << event.numFlops;
+        if (event.duration > 0)
+        {
+          sm << ",\"GB/s\":"   << event.numBytes / event.duration * 1e-9
+             << ",\"GFLOPS\":" << event.numFlops / event.duration * 1e-9;
+        }
+        sm << "}";
+      }
+
+      sm << "}";
+    }
+
+    sm << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    return sm.str();
+  }
+
+  void Profiler::printSummary(std::ostream& sm) const
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    struct Total
+    {
+      int count = 0;
+      double duration = 0;
+      size_t numBytes = 0;
+      double numFlops = 0;
+    };
+
+    // Aggregate the operation events by name, keeping the order of their first occurrence
+    std::vector<std::string> names;
+    std::map<std::string, Total> totals;
+    double totalDuration = 0;
+
+    for (const Event& event : events)
+    {
+      if (event.category != "op")
+        continue;
+
+      auto iter = totals.find(event.name);
+      if (iter == totals.end())
+      {
+        names.push_back(event.name);
+        iter = totals.emplace(event.name, Total()).first;
+      }
+
+      Total& total = iter->second;
+      total.count++;
+      total.duration += event.duration;
+      total.numBytes += event.numBytes;
+      total.numFlops += event.numFlops;
+      totalDuration += event.duration;
+    }
+
+    const std::ios::fmtflags flags = sm.flags();
+    sm << std::fixed << std::setprecision(3);
+    sm << "Profile:" << std::endl;
+    sm << "  " << std::left << std::setw(16) << "op" << std::right
+       << std::setw(6) << "count" << std::setw(12) << "msec"
+       << std::setw(10) << "GB/s" << std::setw(10) << "GFLOPS" << std::endl;
+
+    for (const std::string& name : names)
+    {
+      const Total& total = totals[name];
+      const double rcpDuration = (total.duration > 0) ? 1. / total.duration : 0.;
+      sm << "  " << std::left << std::setw(16) << name << std::right
+         << std::setw(6) << total.count << std::setw(12) << total.duration * 1000
+         << std::setw(10) << total.numBytes * rcpDuration * 1e-9
+         << std::setw(10) << total.numFlops * rcpDuration * 1e-9 << std::endl;
+    }
+
+    sm << "  " << std::left << std::setw(16) << "total" << std::right
+       << std::setw(6) << "" << std::setw(12) << totalDuration * 1000 << std::endl;
+    sm.flags(flags);
+  }
+
+OIDN_NAMESPACE_END
@@ -0,0 +1,56 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "common/common.h"
+#include "common/timer.h"
+#include <mutex>
+
+OIDN_NAMESPACE_BEGIN
+
+  class Engine;
+  class Op;
+
+  // Records the execution time and estimated cost of operations, which can be exported in the
+  // Chrome trace event format (viewable in chrome://tracing or Perfetto)
+  class Profiler
+  {
+  public:
+    // Clears the recorded events and restarts the clock
+    void reset();
+
+    // Returns the time elapsed since the last reset in seconds
+    double getTime() const { return timer.query(); }
+
+    // Records an event which started at the specified time and ends now
+    void record(const std::string& name, const std::string& category, int threadID,
+                double beginTime, size_t numBytes = 0, double numFlops = 0);
+
+    // Runs an operation synchronously and records its execution time and cost
+    void run(Engine* engine, Op& op, int threadID);
+
+    // Returns the recorded events in the Chrome trace event JSON format
+    std::string getChromeTrace() const;
+
+    // Prints the total time and cost of the recorded operations, aggregated by name
+    void printSummary(std::ostream& sm) const;
+
+  private:
+    struct Event
+    {
+      std::string name;
+      std::string category;
+      int threadID;     // thread lane in the trace (e.g. model instance processing a tile)
+      double beginTime; // in seconds
+      double duration;  // in seconds
+      size_t numBytes;  // estimated amount of memory accessed
+      double numFlops;  // estimated number of floating-point operations
+    };
+
+    mutable std::mutex mutex;
+    Timer timer;
+    std::vector<Event> events;
+  };
+
+OIDN_NAMESPACE_END
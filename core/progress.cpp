@@ -30,10 +30,10 @@ OIDN_NAMESPACE_BEGIN
       this->total = total;
       this->current = 0;
 
-      call();
+      call(engine);
     });
 
-    checkCancelled();
+    checkCancelled(engine);
   }
 
   void Progress::update(Engine* engine, double done)
@@ -47,10 +47,10 @@ OIDN_NAMESPACE_BEGIN
     {
       std::lock_guard<std::mutex> lock(mutex);
       current = std::min(current + done, total);
-      call();
+      call(engine);
     });
 
-    checkCancelled();
+    checkCancelled(engine);
   }
 
   void Progress::finish(Engine* engine)
@@ -66,14 +66,14 @@ OIDN_NAMESPACE_BEGIN
       if (current < total)
       {
         current = total;
-        call();
+        call(engine);
       }
 
       func = nullptr; // do not call the function anymore
     });
   }
 
-  void Progress::call()
+  void Progress::call(Engine* engine)
   {
     if (!func)
       return;
@@ -82,13 +82,19 @@ OIDN_NAMESPACE_BEGIN
     {
       cancelled = true;
       func = nullptr; // do not call the function anymore, more updates could be already queued
+      engine->cancelSubmitted(); // skip the remaining work if possible
     }
   }
 
-  void Progress::checkCancelled()
+  void Progress::checkCancelled(Engine* engine)
   {
     if (cancelled)
+    {
+      // Wait for the already submitted work to be completed or discarded first, which also reports
+      // the pending cancellation error of the engine, if any
+      engine->wait();
       throw Exception(Error::Cancelled, "execution was cancelled");
+    }
   }
 
 OIDN_NAMESPACE_END
@@ -24,10 +24,10 @@ OIDN_NAMESPACE_BEGIN
 
   private:
     // Calls the progress monitor function
-    void call();
+    void call(Engine* engine);
 
     // Checks whether cancellation has been requested
-    void checkCancelled();
+    void checkCancelled(Engine* engine);
 
     bool enabled; // is progress monitoring currently enabled?
     std::atomic<bool> cancelled; // has cancellation been requested by the callback?
@@ -17,6 +17,18 @@
   #include "weights/rt_nrm.h"
 #endif
 
+// Weights of the smaller networks for fast quality mode
+#if defined(OIDN_FILTER_RT_SMALL)
+  #include "weights/rt_hdr_small.h"
+  #include "weights/rt_hdr_alb_small.h"
+  #include "weights/rt_hdr_alb_nrm_small.h"
+  #include "weights/rt_hdr_calb_cnrm_small.h"
+  #include "weights/rt_ldr_small.h"
+  #include "weights/rt_ldr_alb_small.h"
+  #include "weights/rt_ldr_alb_nrm_small.h"
+  #include "weights/rt_ldr_calb_cnrm_small.h"
+#endif
+
 OIDN_NAMESPACE_BEGIN
 
   RTFilter::RTFilter(const Ref<Device>& device)
@@ -34,6 +46,17 @@ OIDN_NAMESPACE_BEGIN
     weightsBlobs.alb           = blobs::weights::rt_alb;
     weightsBlobs.nrm           = blobs::weights::rt_nrm;
   #endif
+
+  #if defined(OIDN_FILTER_RT_SMALL)
+    smallWeightsBlobs.hdr           = blobs::weights::rt_hdr_small;
+    smallWeightsBlobs.hdr_alb       = blobs::weights::rt_hdr_alb_small;
+    smallWeightsBlobs.hdr_alb_nrm   = blobs::weights::rt_hdr_alb_nrm_small;
+    smallWeightsBlobs.hdr_calb_cnrm = blobs::weights::rt_hdr_calb_cnrm_small;
+    smallWeightsBlobs.ldr           = blobs::weights::rt_ldr_small;
+    smallWeightsBlobs.ldr_alb       = blobs::weights::rt_ldr_alb_small;
+    smallWeightsBlobs.ldr_alb_nrm   = blobs::weights::rt_ldr_alb_nrm_small;
+    smallWeightsBlobs.ldr_calb_cnrm = blobs::weights::rt_ldr_calb_cnrm_small;
+  #endif
   }
 
   std::shared_ptr<TransferFunction> RTFilter::newTransferFunc()
@@ -48,14 +71,27 @@ OIDN_NAMESPACE_BEGIN
 
   void RTFilter::setImage(const std::string& name, const Ref<Image>& image)
   {
+    // Setting an image also marks its contents as changed (for streaming mode)
     if (name == "color")
+    {
       setParam(color, image);
+      dirtyColor = true;
+    }
     else if (name == "albedo")
+    {
       setParam(albedo, image);
+      dirtyAux = true;
+    }
     else if (name == "normal")
+    {
       setParam(normal, image);
+      dirtyAux = true;
+    }
     else if (name == "output")
+    {
       setParam(output, image);
+      dirtyColor = true;
+    }
     else
       device->printWarning("unknown filter parameter or type mismatch: '" + name + "'");
 
@@ -86,6 +122,8 @@ OIDN_NAMESPACE_BEGIN
       setParam(srgb, value);
     else if (name == "cleanAux")
       setParam(cleanAux, value);
+    else if (name == "streaming")
+      setParam(streaming, value);
     else
       UNetFilter::setInt(name, value);
 
@@ -100,6 +138,8 @@ OIDN_NAMESPACE_BEGIN
       return srgb;
     else if (name == "cleanAux")
       return cleanAux;
+    else if (name == "streaming")
+      return streaming;
     else
       return UNetFilter::getInt(name);
   }
@@ -0,0 +1,73 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "shared_weights.h"
+#include "engine.h"
+#include <cstring>
+#include <map>
+
+OIDN_NAMESPACE_BEGIN
+
+  std::shared_ptr<SharedWeights> SharedWeights::get(Engine* engine, const Data& blob, bool builtin,
+                                                    uint64_t blobHash,
+                                                    const std::shared_ptr<const void>& blobOwner)
+  {
+    static std::mutex registryMutex;
+    static std::multimap<Key, std::weak_ptr<SharedWeights>> registry;
+
+    Device* device = engine->getDevice();
+
+    // Weights stored on the device can be used only by the engine which created them
+    Key key;
+    key.deviceType     = static_cast<int>(device->getType());
+    key.engine         = device->needWeightAndBiasOnDevice() ? engine : nullptr;
+    key.builtinBlob    = builtin ? blob.ptr : nullptr;
+    key.blobHash       = builtin ? 0 : blobHash;
+    key.blobByteSize   = blob.size;
+    key.weightLayout   = static_cast<int>(device->getWeightLayout());
+    key.weightDataType = static_cast<int>(device->getWeightDataType());
+    key.tensorBlockC   = device->getTensorBlockC();
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+
+    // Remove the weights which are not used anymore, whose engines may have been destroyed as well
+    for (auto it = registry.begin(); it != registry.end(); )
+    {
+      if (it->second.expired())
+        it = registry.erase(it);
+      else
+        ++it;
+    }
+
+    // Different user weights with the same hash are stored in separate entries
+    auto range = registry.equal_range(key);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+      std::shared_ptr<SharedWeights> weights = it->second.lock();
+      if (weights && (builtin || weights->blob.ptr == blob.ptr ||
+                      memcmp(weights->blob.ptr, blob.ptr, blob.size) == 0))
+        return weights;
+    }
+
+    std::shared_ptr<SharedWeights> weights = std::make_shared<SharedWeights>();
+    if (!builtin)
+    {
+      if (blobOwner)
+      {
+        weights->blob = blob;
+        weights->blobOwner = blobOwner;
+      }
+      else
+      {
+        // The user weights blob may be modified or freed after the filter is committed
+        const char* blobPtr = static_cast<const char*>(blob.ptr);
+        auto blobCopy = std::make_shared<std::vector<char>>(blobPtr, blobPtr + blob.size);
+        weights->blob = Data(blobCopy->data(), blobCopy->size());
+        weights->blobOwner = blobCopy;
+      }
+    }
+    registry.emplace(key, weights);
+    return weights;
+  }
+
+OIDN_NAMESPACE_END
@@ -0,0 +1,65 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "tensor.h"
+#include "data.h"
+#include <mutex>
+#include <tuple>
+
+OIDN_NAMESPACE_BEGIN
+
+  class Engine;
+
+  // Final weights of a model, already converted to the native weight layout and data type of the
+  // device, shared process-wide by all filters using the same model. The weights are identified by
+  // the address of the built-in weights blob or by the contents of user weights (looked up by their
+  // hash), thus identical user weights are stored in memory only once too. If the final weights are
+  // stored in host memory, they are shared across all devices of the same type and weight format,
+  // otherwise only by the filters running on the same engine. The weights are released when they
+  // are not referenced by any filter or subdevice anymore.
+  class SharedWeights final
+  {
+  public:
+    // Gets the shared final weights of a weights blob for an engine, which are initially empty
+    // The hash of the blob contents is ignored for built-in weights. Since different user weights
+    // may have the same hash, their contents are compared with the blob of the shared weights too,
+    // which is either kept alive by the specified owner (e.g. a mapped file) or copied.
+    static std::shared_ptr<SharedWeights> get(Engine* engine, const Data& blob, bool builtin,
+                                              uint64_t blobHash = 0,
+                                              const std::shared_ptr<const void>& blobOwner = nullptr);
+
+    // The tensors may be accessed only while holding the mutex because the weights may be shared
+    // with filters of other devices, which are not synchronized by the device lock
+    std::mutex& getMutex() { return mutex; }
+    const std::shared_ptr<TensorMap>& getTensors() const { return tensors; }
+
+  private:
+    struct Key
+    {
+      int deviceType;
+      const void* engine;      // engine storing the weights, null if stored in host memory
+      const void* builtinBlob; // built-in weights blob, null for user weights
+      uint64_t blobHash;       // hash of the user weights blob
+      uint64_t blobByteSize;
+      int weightLayout;        // native weight layout
+      int weightDataType;
+      int tensorBlockC;
+
+      bool operator <(const Key& other) const
+      {
+        return std::tie(deviceType, engine, builtinBlob, blobHash, blobByteSize,
+                        weightLayout, weightDataType, tensorBlockC) <
+               std::tie(other.deviceType, other.engine, other.builtinBlob, other.blobHash, other.blobByteSize,
+                        other.weightLayout, other.weightDataType, other.tensorBlockC);
+      }
+    };
+
+    std::mutex mutex;
+    std::shared_ptr<TensorMap> tensors = std::make_shared<TensorMap>();
+    Data blob;                             // user weights blob, empty for built-in weights
+    std::shared_ptr<const void> blobOwner; // keeps the user weights blob alive
+  };
+
+OIDN_NAMESPACE_END
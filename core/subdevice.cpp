@@ -25,12 +25,14 @@ OIDN_NAMESPACE_BEGIN
       scratchArenaManager->trim();
   }
 
-  std::shared_ptr<TensorMap> Subdevice::getCachedTensors(const void* key)
+  size_t Subdevice::getScratchByteSize() const
   {
-    std::shared_ptr<TensorMap>& tensorMap = cachedTensors[key];
-    if (!tensorMap)
-      tensorMap = std::make_shared<TensorMap>();
-    return tensorMap;
+    return scratchArenaManager ? scratchArenaManager->getByteSize() : 0;
+  }
+
+  void Subdevice::retainWeights(const std::shared_ptr<SharedWeights>& weights)
+  {
+    retainedWeights.insert(weights);
   }
 
 OIDN_NAMESPACE_END
\ No newline at end of file
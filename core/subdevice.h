@@ -5,7 +5,8 @@
 
 #include "device.h"
 #include "arena.h"
-#include "tensor.h"
+#include "shared_weights.h"
+#include <unordered_set>
 
 OIDN_NAMESPACE_BEGIN
 
@@ -20,9 +21,10 @@ OIDN_NAMESPACE_BEGIN
     // Scratch
     Ref<Arena> newScratchArena(size_t byteSize, const std::string& name = "");
     void trimScratch();
+    size_t getScratchByteSize() const;
 
-    // Tensor cache
-    std::shared_ptr<TensorMap> getCachedTensors(const void* key);
+    // Keeps shared weights alive until the subdevice is destroyed (e.g. built-in weights)
+    void retainWeights(const std::shared_ptr<SharedWeights>& weights);
 
   private:
     // Disable copying
@@ -33,7 +35,7 @@ OIDN_NAMESPACE_BEGIN
 
     // Resources
     std::unique_ptr<ScratchArenaManager> scratchArenaManager;
-    std::unordered_map<const void*, std::shared_ptr<TensorMap>> cachedTensors; // cached weights
+    std::unordered_set<std::shared_ptr<SharedWeights>> retainedWeights;
   };
 
 OIDN_NAMESPACE_END
\ No newline at end of file
@@ -69,6 +69,8 @@ OIDN_NAMESPACE_BEGIN
       dumpImpl<float, TensorLayout::Chw16c>(filenamePrefix);
     else if (dataType == DataType::Float16 && layout == TensorLayout::chw)
       dumpImpl<half, TensorLayout::chw>(filenamePrefix);
+    else if (dataType == DataType::Float16 && layout == TensorLayout::Chw8c)
+      dumpImpl<half, TensorLayout::Chw8c>(filenamePrefix);
     else if (dataType == DataType::Float16 && layout == TensorLayout::Chw16c)
       dumpImpl<half, TensorLayout::Chw16c>(filenamePrefix);
     else if (dataType == DataType::Float16 && layout == TensorLayout::hwc)
@@ -120,10 +122,11 @@ OIDN_NAMESPACE_BEGIN
       ptr(alignedMalloc(getByteSize())),
       shared(false) {}
 
-  HostTensor::HostTensor(const TensorDesc& desc, void* data)
+  HostTensor::HostTensor(const TensorDesc& desc, void* data, const Ref<RefCount>& dataOwner)
     : Tensor(desc),
       ptr(data),
-      shared(true) {}
+      shared(true),
+      dataOwner(dataOwner) {}
 
   HostTensor::~HostTensor()
   {
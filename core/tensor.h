@@ -232,7 +232,7 @@ OIDN_NAMESPACE_BEGIN
   {
   public:
     explicit HostTensor(const TensorDesc& desc);
-    HostTensor(const TensorDesc& desc, void* data);
+    HostTensor(const TensorDesc& desc, void* data, const Ref<RefCount>& dataOwner = nullptr);
     ~HostTensor();
 
     void* getPtr() const override { return ptr; }
@@ -242,6 +242,7 @@ OIDN_NAMESPACE_BEGIN
   private:
     void* ptr;   // pointer to the tensor data
     bool shared; // data owned and shared by the user
+    Ref<RefCount> dataOwner; // object owning the shared data, kept alive by the tensor (optional)
   };
 
   class DeviceTensor final : public Tensor
@@ -15,6 +15,13 @@ OIDN_NAMESPACE_BEGIN
     int wDstBegin;
     int H;
     int W;
+
+    // Multiple images of the same size may be stacked vertically in the tile (e.g. images of a batch
+    // packed into the same tile), the rows of which are offset by the strides in the source and the
+    // destination
+    int B;          // number of images
+    int hSrcStride; // row offset between the images in the source
+    int hDstStride; // row offset between the images in the destination
   };
 
 OIDN_NAMESPACE_END
\ No newline at end of file
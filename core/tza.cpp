@@ -24,7 +24,7 @@ OIDN_NAMESPACE_BEGIN
     return value;
   }
 
-  std::shared_ptr<TensorMap> parseTZA(const void* buffer, size_t size)
+  std::shared_ptr<TensorMap> parseTZA(const void* buffer, size_t size, TZAMetadata* metadata)
   {
     const char* input = static_cast<const char*>(buffer);
     const char* const bufferEnd = input + size;
@@ -37,7 +37,6 @@ OIDN_NAMESPACE_BEGIN
     // Parse the version
     const int majorVersion = read<uint8_t>(input, bufferEnd);
     const int minorVersion = read<uint8_t>(input, bufferEnd);
-    UNUSED(minorVersion);
     if (majorVersion != 2)
       throw Exception(Error::InvalidOperation, "unsupported weights blob version");
 
@@ -99,6 +98,31 @@ OIDN_NAMESPACE_BEGIN
       tensorMap->emplace(name, tensor);
     }
 
+    // Parse the metadata following the tensors (since version 2.1)
+    if (metadata)
+    {
+      metadata->clear();
+
+      if (minorVersion >= 1)
+      {
+        const size_t numEntries = read<uint32_t>(input, bufferEnd);
+        for (size_t i = 0; i < numEntries; ++i)
+        {
+          const size_t keyLen = read<uint16_t>(input, bufferEnd);
+          checkBounds(input, bufferEnd, keyLen);
+          std::string key(input, keyLen);
+          input += keyLen;
+
+          const size_t valueLen = read<uint32_t>(input, bufferEnd);
+          checkBounds(input, bufferEnd, valueLen);
+          std::string value(input, valueLen);
+          input += valueLen;
+
+          (*metadata)[key] = value;
+        }
+      }
+    }
+
     return tensorMap;
   }
 
@@ -7,7 +7,10 @@
 
 OIDN_NAMESPACE_BEGIN
 
-  // Parses tensors from a Tensor Archive (TZA)
-  std::shared_ptr<TensorMap> parseTZA(const void* buffer, size_t size);
+  // String metadata stored in a Tensor Archive (e.g. the network topology)
+  using TZAMetadata = std::unordered_map<std::string, std::string>;
+
+  // Parses tensors and optionally metadata from a Tensor Archive (TZA)
+  std::shared_ptr<TensorMap> parseTZA(const void* buffer, size_t size, TZAMetadata* metadata = nullptr);
 
 OIDN_NAMESPACE_END
\ No newline at end of file
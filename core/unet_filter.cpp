@@ -3,13 +3,29 @@
 
 #include "unet_filter.h"
 #include "tza.h"
+#include "weights_cache.h"
+#include "hash.h"
 
 OIDN_NAMESPACE_BEGIN
 
+  namespace
+  {
+    // Converts a byte size to MBs, rounded up
+    int toMB(size_t byteSize)
+    {
+      return int(ceil_div(byteSize, size_t(1024*1024)));
+    }
+  }
+
   UNetFilter::UNetFilter(const Ref<Device>& device)
     : Filter(device)
   {
-    // Compute final device-dependent tile alignment and overlap
+    initTileAlignment();
+  }
+
+  // Computes the final device-dependent tile alignment and overlap from the network constants
+  void UNetFilter::initTileAlignment()
+  {
     tileAlignment = lcm(minTileAlignment, device->getMinTileAlignment());
     tileOverlap = round_up(receptiveField / 2, tileAlignment);
   }
@@ -17,7 +33,10 @@ OIDN_NAMESPACE_BEGIN
   void UNetFilter::setData(const std::string& name, const Data& data)
   {
     if (name == "weights")
+    {
       setParam(userWeightsBlob, data);
+      dirtyWeightsHash = true;
+    }
     else
       device->printWarning("unknown filter parameter or type mismatch: '" + name + "'");
 
@@ -27,7 +46,14 @@ OIDN_NAMESPACE_BEGIN
   void UNetFilter::updateData(const std::string& name)
   {
     if (name == "weights")
-      dirtyParam |= userWeightsBlob;
+    {
+      dirtyParam |= userWeightsBlob || !userWeightsPath.empty();
+      dirtyWeightsHash = true;
+    }
+    else if (name == "color" || name == "output")
+      dirtyColor = true;
+    else if (name == "albedo" || name == "normal")
+      dirtyAux = true;
     else
       device->printWarning("unknown filter parameter or type mismatch: '" + name + "'");
 
@@ -44,6 +70,19 @@ OIDN_NAMESPACE_BEGIN
     dirty = true;
   }
 
+  Data UNetFilter::getData(const std::string& name)
+  {
+    if (name == "profile")
+    {
+      if (!device->isProfiling())
+        throw Exception(Error::InvalidOperation, "profiling is not enabled on the device");
+      profileTrace = profiler.getChromeTrace();
+      return {profileTrace.data(), profileTrace.size()};
+    }
+    else
+      throw Exception(Error::InvalidArgument, "unknown filter parameter or type mismatch: '" + name + "'");
+  }
+
   void UNetFilter::setInt(const std::string& name, int value)
   {
     if (name == "quality")
@@ -51,12 +90,28 @@ OIDN_NAMESPACE_BEGIN
       Quality qualityValue = static_cast<Quality>(value);
       if (qualityValue == Quality::Default)
         qualityValue = defaultQuality;
-      else if (qualityValue != Quality::High && qualityValue != Quality::Balanced)
+      else if (qualityValue != Quality::High && qualityValue != Quality::Balanced &&
+               qualityValue != Quality::Fast)
         throw Exception(Error::InvalidArgument, "unknown filter quality mode");
       setParam(quality, qualityValue);
     }
     else if (name == "maxMemoryMB")
       setParam(maxMemoryMB, value);
+    else if (name == "batchSize")
+    {
+      if (value < 1)
+        throw Exception(Error::InvalidArgument, "invalid batch size");
+      setParam(batchSize, value);
+    }
+    // The filter is reinitialized only if the size of the processed region changes (see commit)
+    else if (name == "roiX")
+      roiX = value;
+    else if (name == "roiY")
+      roiY = value;
+    else if (name == "roiW")
+      roiW = value;
+    else if (name == "roiH")
+      roiH = value;
     else
       device->printWarning("unknown filter parameter or type mismatch: '" + name + "'");
 
@@ -69,6 +124,16 @@ OIDN_NAMESPACE_BEGIN
       return static_cast<int>(quality);
     else if (name == "maxMemoryMB")
       return maxMemoryMB;
+    else if (name == "batchSize")
+      return batchSize;
+    else if (name == "roiX")
+      return roiX;
+    else if (name == "roiY")
+      return roiY;
+    else if (name == "roiW")
+      return roiW;
+    else if (name == "roiH")
+      return roiH;
     else if (name == "tileAlignment")
       return tileAlignment;
     else if (name == "alignment")
@@ -83,6 +148,23 @@ OIDN_NAMESPACE_BEGIN
       device->printWarning("filter parameter 'overlap' is deprecated, use 'tileOverlap' instead");
       return tileOverlap;
     }
+    else if (name == "memoryUsageMB")
+    {
+      const Estimate est = estimate();
+      return toMB(est.scratchByteSize + est.weightsByteSize);
+    }
+    else if (name == "scratchMB")
+      return toMB(estimate().scratchByteSize);
+    else if (name == "weightsMB")
+      return toMB(estimate().weightsByteSize);
+    else if (name == "tileCountX")
+      return estimate().tileCountW;
+    else if (name == "tileCountY")
+      return estimate().tileCountH;
+    else if (name == "tileWidth")
+      return estimate().tileW;
+    else if (name == "tileHeight")
+      return estimate().tileH;
     else
       throw Exception(Error::InvalidArgument, "unknown filter parameter or type mismatch: '" + name + "'");
   }
@@ -90,11 +172,11 @@ OIDN_NAMESPACE_BEGIN
   void UNetFilter::setFloat(const std::string& name, float value)
   {
     if (name == "inputScale")
-      inputScale = value;
+      setInputScale(value);
     else if (name == "hdrScale")
     {
       device->printWarning("filter parameter 'hdrScale' is deprecated, use 'inputScale' instead");
-      inputScale = value;
+      setInputScale(value);
     }
     else
       device->printWarning("unknown filter parameter or type mismatch: '" + name + "'");
@@ -102,6 +184,17 @@ OIDN_NAMESPACE_BEGIN
     dirty = true;
   }
 
+  void UNetFilter::setInputScale(float value)
+  {
+    // Images packed into the same tile share the input scale, so computing it for each image of the
+    // batch requires reinitialization
+    if (hdr && math::isnan(value) && tileBatchSize > 1)
+      dirtyParam = true;
+
+    inputScale = value;
+    dirtyColor = true;
+  }
+
   float UNetFilter::getFloat(const std::string& name)
   {
     if (name == "inputScale")
@@ -115,17 +208,49 @@ OIDN_NAMESPACE_BEGIN
       throw Exception(Error::InvalidArgument, "unknown filter parameter or type mismatch: '" + name + "'");
   }
 
+  void UNetFilter::setString(const std::string& name, const std::string& value)
+  {
+    if (name == "weightsPath")
+      setParam(userWeightsPath, value);
+    else
+      device->printWarning("unknown filter parameter or type mismatch: '" + name + "'");
+
+    dirty = true;
+  }
+
+  const char* UNetFilter::getString(const std::string& name)
+  {
+    if (name == "weightsPath")
+      return userWeightsPath.c_str();
+    else
+      throw Exception(Error::InvalidArgument, "unknown filter parameter or type mismatch: '" + name + "'");
+  }
+
   void UNetFilter::commit()
   {
     if (!dirty)
       return;
 
     // Determine whether in-place filtering is required
-    bool inplaceNew = output &&
-                      ((color  && output->overlaps(*color))  ||
-                       (albedo && output->overlaps(*albedo)) ||
-                       (normal && output->overlaps(*normal)));
-    setParam(inplace, inplaceNew);
+    setParam(inplace, isInplace());
+
+    // Moving the region of interest does not require reinitialization if the size of the processed
+    // region does not change
+    if (!dirtyParam && H > 0 && W > 0)
+    {
+      int newRegionY, newRegionX, newRegionH, newRegionW;
+      getRegion(newRegionY, newRegionX, newRegionH, newRegionW);
+
+      if (newRegionH != regionH || newRegionW != regionW)
+        dirtyParam = true;
+      else if (newRegionY != regionY || newRegionX != regionX)
+      {
+        regionY = newRegionY;
+        regionX = newRegionX;
+        dirtyColor = true; // the region must be processed again
+        dirtyAux   = true;
+      }
+    }
 
     if (dirtyParam)
     {
@@ -136,16 +261,83 @@ OIDN_NAMESPACE_BEGIN
       device->getEngine()->runHostTask([&]() { init(); });
       device->wait();
 
-      // Clean up the device memory if the memory usage limit has been reduced
-      if (maxMemoryMB >= 0 && (maxMemoryMB < prevMaxMemoryMB || prevMaxMemoryMB < 0))
+      // Clean up the device memory if the memory usage limit has been reduced or the memory
+      // budget of the device is exceeded (e.g. by heaps grown for filters which have shrunk since)
+      if ((maxMemoryMB >= 0 && (maxMemoryMB < prevMaxMemoryMB || prevMaxMemoryMB < 0)) ||
+          device->isMemoryBudgetExceeded())
         device->trimScratch();
       prevMaxMemoryMB = maxMemoryMB;
+
+      // Nothing can be reused from previous executions
+      dirtyColor = true;
+      dirtyAux   = true;
     }
 
     dirty = false;
     dirtyParam = false;
   }
 
+  // Estimates the memory usage and the tiling for the current parameters
+  // If they have changed since the last commit, the model is planned without allocating any memory
+  // or processing the weights, and the committed model is kept intact until the next commit
+  UNetFilter::Estimate UNetFilter::estimate()
+  {
+    // The committed model is still valid if it would not be reinitialized by committing (see commit)
+    bool dirtyModel = dirtyParam || inplace != isInplace();
+    if (!dirtyModel && H > 0 && W > 0)
+    {
+      int newRegionY, newRegionX, newRegionH, newRegionW;
+      getRegion(newRegionY, newRegionX, newRegionH, newRegionW);
+      dirtyModel = newRegionH != regionH || newRegionW != regionW;
+    }
+
+    if (!dirtyModel)
+      return {totalScratchByteSize, totalWeightsByteSize, tileH, tileW, tileCountH, tileCountW};
+
+    // Make sure that all asynchronous operations have completed before planning
+    device->wait();
+
+    // Set aside the state of the committed model, which is overwritten while planning
+    const auto committedTiling =
+      std::make_tuple(H, W, regionY, regionX, regionH, regionW,
+                      tileH, tileW, tilePadH, tilePadW, tileCountH, tileCountW,
+                      tileBatchSize, tileOverlap, tileAlignment, tileConcurrency, inplace, keepInput, pipelined,
+                      receptiveField, minTileAlignment, totalScratchByteSize, totalWeightsByteSize);
+    const auto committedModel =
+      std::make_tuple(topology, autoexposure, autoexposureDsts, imageCopy, outputBand, outputCarry);
+    std::vector<Instance> committedInstances;
+    committedInstances.swap(instances);
+
+    auto restore = [&]()
+    {
+      std::tie(H, W, regionY, regionX, regionH, regionW,
+               tileH, tileW, tilePadH, tilePadW, tileCountH, tileCountW,
+               tileBatchSize, tileOverlap, tileAlignment, tileConcurrency, inplace, keepInput, pipelined,
+               receptiveField, minTileAlignment, totalScratchByteSize, totalWeightsByteSize) = committedTiling;
+      std::tie(topology, autoexposure, autoexposureDsts, imageCopy, outputBand, outputCarry) = committedModel;
+      instances.swap(committedInstances);
+    };
+
+    Estimate est;
+    try
+    {
+      inplace = isInplace();
+      totalScratchByteSize = 0;
+      totalWeightsByteSize = 0;
+      device->getEngine()->runHostTask([&]() { init(true); });
+      device->wait();
+      est = {totalScratchByteSize, totalWeightsByteSize, tileH, tileW, tileCountH, tileCountW};
+    }
+    catch (...)
+    {
+      restore();
+      throw;
+    }
+
+    restore();
+    return est;
+  }
+
   void UNetFilter::execute(SyncMode sync)
   {
     if (dirty)
@@ -154,193 +346,689 @@ OIDN_NAMESPACE_BEGIN
     if (H <= 0 || W <= 0)
       return;
 
+    // In streaming mode, only the work depending on the changed images is done again
+    const bool updateColor = !streaming || dirtyColor;
+    const bool updateAux   = !streaming || dirtyAux;
+    if (!updateColor && !updateAux)
+      return; // the output is already up to date
+
     auto mainEngine = device->getEngine();
 
     mainEngine->runHostTask([&]()
     {
       // Initialize the progress state
-      double workAmount = tileCountH * tileCountW * instances[0].graph->getWorkAmount();
-      if (hdr && math::isnan(inputScale))
-        workAmount += 1;
-      if (outputTemp)
+      const int tileCount = getNumTiles();
+      double workAmount = tileCount * instances[0].graph->getWorkAmount();
+      if (hdr && math::isnan(inputScale) && updateColor)
+        workAmount += batchSize;
+      if (outputBand)
         workAmount += 1;
       progress.start(mainEngine, progressFunc, progressUserPtr, workAmount);
 
+      // Profiling synchronizes after each operation to measure its execution time
+      Profiler* profiler = device->isProfiling() ? &this->profiler : nullptr;
+      if (profiler)
+        profiler->reset();
+
       // Set the input scale
-      if (math::isnan(inputScale))
+      // In HDR mode with automatic exposure, the input scale of each image in the batch is computed
+      // separately and set for each tile, and in streaming mode only if the color has changed
+      if (math::isnan(inputScale) && hdr)
       {
-        if (hdr)
+        if (updateColor)
         {
-          autoexposure->setSrc(color);
-          autoexposure->submit();
+          for (int b = 0; b < batchSize; ++b)
+          {
+            autoexposure->setSrc(batchSize > 1 ? color->newRows(b * H, H) : color);
+            autoexposure->setDst(autoexposureDsts[b]);
+            if (profiler)
+              profiler->run(mainEngine, *autoexposure, 0);
+            else
+              autoexposure->submit();
+          }
           device->submitBarrier();
-          progress.update(mainEngine, 1);
-          transferFunc->setInputScale(autoexposure->getDstPtr());
-        }
-        else
-        {
-          transferFunc->setInputScale(1);
+          progress.update(mainEngine, batchSize);
         }
       }
       else
       {
-        transferFunc->setInputScale(inputScale);
+        for (auto& instance : instances)
+        {
+          instance.inputTransferFunc->setInputScale(math::isnan(inputScale) ? 1.f : inputScale);
+          instance.outputTransferFunc->setInputScale(math::isnan(inputScale) ? 1.f : inputScale);
+        }
       }
 
       // Set the input and output
+      // If the auxiliary features have not changed, the instances keeping their input process only
+      // the color again
       for (auto& instance : instances)
       {
         instance.inputProcess->setSrc(color, albedo, normal);
-        instance.outputProcess->setDst(outputTemp ? outputTemp : output);
+        instance.inputProcess->setKeepAux(keepInput && !updateAux);
+        instance.outputProcess->setDst(outputBand ? outputBand : output);
       }
 
-      // Iterate over the tiles
-      int tileIndex = 0;
-
-      for (int i = 0; i < tileCountH; ++i)
+      // Iterate over the tiles of all images in the batch
+      if (outputBand)
       {
-        const int h = i * (tileH - (2*tileOverlap+tilePadH)); // input tile position (including overlaps)
-        const int overlapBeginH = i > 0            ? tileOverlap : 0; // overlap on the top
-        const int overlapEndH   = i < tileCountH-1 ? tileOverlap+tilePadH : 0; // overlap on the bottom
-        const int tileH1 = min(H - h, tileH); // input tile size (including overlaps)
-        const int tileH2 = tileH1 - overlapBeginH - overlapEndH; // output tile size
-        const int alignOffsetH = tileH - round_up(tileH1, minTileAlignment); // align to the bottom in the tile buffer
-
-        for (int j = 0; j < tileCountW; ++j)
+        // If filtering in-place, process the tiles row by row, and copy the staged output of each
+        // row to the output image once the next row has read its input
+        outputCarryH = 0;
+        for (int band = 0; band < batchSize * tileCountH; ++band)
         {
-          const int w = j * (tileW - (2*tileOverlap+tilePadW)); // input tile position (including overlaps)
-          const int overlapBeginW = j > 0            ? tileOverlap : 0; // overlap on the left
-          const int overlapEndW   = j < tileCountW-1 ? tileOverlap+tilePadW : 0; // overlap on the right
-          const int tileW1 = min(W - w, tileW); // input tile size (including overlaps)
-          const int tileW2 = tileW1 - overlapBeginW - overlapEndW; // output tile size
-          const int alignOffsetW = tileW - round_up(tileW1, minTileAlignment); // align to the right in the tile buffer
-
-          auto& instance = instances[tileIndex % device->getNumSubdevices()];
-
-          // Set the input tile
-          instance.inputProcess->setTile(
-            h, w,
-            alignOffsetH, alignOffsetW,
-            tileH1, tileW1);
-
-          // Set the output tile
-          instance.outputProcess->setTile(
-            alignOffsetH + overlapBeginH, alignOffsetW + overlapBeginW,
-            h + overlapBeginH, w + overlapBeginW,
-            tileH2, tileW2);
-
-          //printf("Tile: %d %d -> %d %d\n", w+overlapBeginW, h+overlapBeginH, w+overlapBeginW+tileW2, h+overlapBeginH+tileH2);
-
-          // Denoise the tile
-          instance.graph->run(progress);
-
-          // Next tile
-          tileIndex++;
+          runTiles(band * tileCountW, (band + 1) * tileCountW);
+          device->submitBarrier();
+          copyOutputBand(band);
         }
       }
+      else
+        runTiles(0, tileCount);
 
       device->submitBarrier();
 
-      // Copy the output image to the final buffer if filtering in-place
-      if (outputTemp)
-      {
-        imageCopy->setDst(output);
-        imageCopy->submit();
-      }
-
       // Finished
       progress.finish(mainEngine);
+
+      if (profiler && device->isVerbose(2))
+        profiler->printSummary(std::cout);
     });
 
+    dirtyColor = false;
+    dirtyAux   = false;
+
     if (sync == SyncMode::Sync)
       device->wait();
     else
       device->flush();
   }
 
-  void UNetFilter::init()
+  // Gets the position and size of a tile, returns false if it does not contribute to the output
+  // If multiple images are packed into the tile, the position and size are those of the first image
+  bool UNetFilter::getTile(int tileIndex, TileInfo& tile) const
   {
-    cleanup();
-    checkParams();
+    const int b = tileIndex / (tileCountH * tileCountW) * tileBatchSize; // image index in the batch
+    const int i = (tileIndex / tileCountW) % tileCountH;
+    const int j = tileIndex % tileCountW;
+    const int hBatch = b * H; // row offset of the image in the batch
+
+    const int h = regionY + i * (tileH - (2*tileOverlap+tilePadH)); // input tile position (including overlaps)
+    const int overlapBeginH = i > 0            ? tileOverlap : 0; // overlap on the top
+    const int overlapEndH   = i < tileCountH-1 ? tileOverlap+tilePadH : 0; // overlap on the bottom
+    const int tileH1 = min(regionY + regionH - h, tileH); // input tile size (including overlaps)
+    const int tileH2 = tileH1 - overlapBeginH - overlapEndH; // output tile size
+    const int alignOffsetH = (tileBatchSize > 1) ? 0 : tileH - round_up(tileH1, minTileAlignment); // align to the bottom in the tile buffer (or to the top if packed)
+
+    const int w = regionX + j * (tileW - (2*tileOverlap+tilePadW)); // input tile position (including overlaps)
+    const int overlapBeginW = j > 0            ? tileOverlap : 0; // overlap on the left
+    const int overlapEndW   = j < tileCountW-1 ? tileOverlap+tilePadW : 0; // overlap on the right
+    const int tileW1 = min(regionX + regionW - w, tileW); // input tile size (including overlaps)
+    const int tileW2 = tileW1 - overlapBeginW - overlapEndW; // output tile size
+    const int alignOffsetW = tileW - round_up(tileW1, minTileAlignment); // align to the right in the tile buffer
+
+    // Clip the output tile to the region of interest
+    const int hOutBegin = hasROI() ? max(h + overlapBeginH, roiY) : h + overlapBeginH;
+    const int hOutEnd   = hasROI() ? min(h + overlapBeginH + tileH2, roiY + roiH) : h + overlapBeginH + tileH2;
+    const int wOutBegin = hasROI() ? max(w + overlapBeginW, roiX) : w + overlapBeginW;
+    const int wOutEnd   = hasROI() ? min(w + overlapBeginW + tileW2, roiX + roiW) : w + overlapBeginW + tileW2;
+
+    //printf("Tile: %d %d -> %d %d\n", w+overlapBeginW, h+overlapBeginH, w+overlapBeginW+tileW2, h+overlapBeginH+tileH2);
+
+    tile.b = b;
+    tile.numImages = min(tileBatchSize, batchSize - b);
+    tile.hSrc = hBatch + h;
+    tile.wSrc = w;
+    tile.srcH = tileH1;
+    tile.srcW = tileW1;
+    tile.alignOffsetH = alignOffsetH;
+    tile.alignOffsetW = alignOffsetW;
+    tile.hDst = hBatch + hOutBegin;
+    tile.wDst = wOutBegin;
+    tile.dstH = hOutEnd - hOutBegin;
+    tile.dstW = wOutEnd - wOutBegin;
+
+    return tile.dstH > 0 && tile.dstW > 0;
+  }
 
-    // Build the model
-    Data weightsBlob = getWeights();
-    auto constTensors = parseTZA(weightsBlob.ptr, weightsBlob.size);
-    const bool fastMath = quality == Quality::Balanced;
+  void UNetFilter::setInputTile(Instance& instance, const TileInfo& tile)
+  {
+    // Set the input scale of the image
+    if (hdr && math::isnan(inputScale))
+      instance.inputTransferFunc->setInputScale(autoexposureDsts[tile.b]->getPtr());
+
+    instance.inputProcess->setTile(
+      tile.hSrc, tile.wSrc,
+      tile.alignOffsetH, tile.alignOffsetW,
+      tile.srcH, tile.srcW,
+      tile.numImages, H, getPackedImageStride());
+  }
+
+  void UNetFilter::setOutputTile(Instance& instance, const TileInfo& tile)
+  {
+    // Set the input scale of the image
+    if (hdr && math::isnan(inputScale))
+      instance.outputTransferFunc->setInputScale(autoexposureDsts[tile.b]->getPtr());
+
+    // If filtering in-place, the output of the tile is staged in the row of the output band, which
+    // starts at the same row for all tiles in the row and covers the processed region
+    const int hDst = outputBand ? 0 : tile.hDst;
+    const int wDst = outputBand ? tile.wDst - regionX : tile.wDst;
+
+    instance.outputProcess->setTile(
+      tile.alignOffsetH + (tile.hDst - tile.hSrc), tile.alignOffsetW + (tile.wDst - tile.wSrc),
+      hDst, wDst,
+      tile.dstH, tile.dstW,
+      tile.numImages, getPackedImageStride(), H);
+  }
+
+  void UNetFilter::runTile(int tileIndex, int instanceID)
+  {
+    auto& instance = instances[instanceID];
 
-    for (int i = 0; i < device->getNumSubdevices(); ++i)
+    // Skip the tile if it does not contribute to the region of interest
+    TileInfo tile;
+    if (!getTile(tileIndex, tile))
     {
-      Engine* engine = device->getEngine(i);
+      progress.update(device->getEngine(instanceID % device->getNumSubdevices()),
+                      instance.graph->getWorkAmount());
+      return;
+    }
 
-      // We can use cached weights only for built-in weights because user weights may change!
-      auto cachedConstTensors =
-        userWeightsBlob ? nullptr : engine->getSubdevice()->getCachedTensors(weightsBlob.ptr);
-      
-      instances.emplace_back();
-      instances.back().graph = makeRef<Graph>(engine, constTensors, cachedConstTensors, fastMath);
+    // Set the input and output tile
+    setInputTile(instance, tile);
+    setOutputTile(instance, tile);
+
+    // Denoise the tile
+    if (device->isProfiling())
+    {
+      const double beginTime = profiler.getTime();
+      instance.graph->run(progress, &profiler, instanceID);
+      profiler.record("tile" + toString(tileIndex), "tile", instanceID, beginTime);
     }
+    else
+      instance.graph->run(progress);
+  }
 
-    transferFunc = newTransferFunc();
+  // Processes a range of tiles of the batch
+  void UNetFilter::runTiles(int tileBegin, int tileEnd)
+  {
+    const int numSubdevices = device->getNumSubdevices();
+    const int numInstances  = int(instances.size());
 
-    // Try to divide the image into tiles until the memory usage gets below the specified threshold
-    // and the number of tiles is a multiple of the number of subdevices
-    H = output->getH();
+    if (tileConcurrency > 1)
+    {
+      // Process multiple tiles concurrently on each subdevice, distributing them statically
+      // The tasks may be recorded for asynchronous execution, so the distribution must not depend
+      // on the order in which they run. The tile with index i is always processed by instance
+      // i % numInstances, thus instances keeping their input process the same tile as in the
+      // previous execution.
+      for (int subdeviceID = 0; subdeviceID < numSubdevices; ++subdeviceID)
+      {
+        device->getEngine(subdeviceID)->runConcurrentHostTasks(tileConcurrency, [&](int slot)
+        {
+          for (int tileIndex = tileBegin; tileIndex < tileEnd; ++tileIndex)
+          {
+            const int instanceID = tileIndex % numInstances;
+            if (instanceID % numSubdevices == subdeviceID && instanceID / numSubdevices == slot)
+              runTile(tileIndex, instanceID);
+          }
+        });
+      }
+    }
+    else if (pipelined)
+      runPipelinedTiles(tileBegin, tileEnd);
+    else
+    {
+      for (int tileIndex = tileBegin; tileIndex < tileEnd; ++tileIndex)
+        runTile(tileIndex, tileIndex % numSubdevices);
+    }
+  }
+
+  // Processes the tiles in a software pipeline: the input processing of the next tile overlaps with
+  // the tail of the current tile, and the output processing of the previous tile overlaps with the
+  // head of the current tile. The input and output tensors of the graph are persistent, so these do
+  // not conflict, and the memory-bound processing steps can use the threads idling in the convolutions.
+  void UNetFilter::runPipelinedTiles(int tileBegin, int tileEnd)
+  {
+    Engine* engine = device->getEngine();
+    auto& instance = instances[0];
+    Graph& graph = *instance.graph;
+
+    // Skip the tiles which do not contribute to the region of interest
+    std::vector<TileInfo> tiles;
+    for (int tileIndex = tileBegin; tileIndex < tileEnd; ++tileIndex)
+    {
+      TileInfo tile;
+      if (getTile(tileIndex, tile))
+        tiles.push_back(tile);
+      else
+        progress.update(engine, graph.getWorkAmount());
+    }
+
+    if (tiles.empty())
+      return;
+
+    setInputTile(instance, tiles[0]);
+    graph.run(GraphStage::Input, progress);
+
+    for (size_t t = 0; t < tiles.size(); ++t)
+    {
+      engine->runOverlappedHostTasks(
+        [&]() { graph.run(GraphStage::Head, progress); },
+        [&]()
+        {
+          if (t > 0)
+          {
+            setOutputTile(instance, tiles[t-1]);
+            graph.run(GraphStage::Output, progress);
+          }
+        });
+
+      engine->runOverlappedHostTasks(
+        [&]() { graph.run(GraphStage::Tail, progress); },
+        [&]()
+        {
+          if (t + 1 < tiles.size())
+          {
+            setInputTile(instance, tiles[t+1]);
+            graph.run(GraphStage::Input, progress);
+          }
+        });
+    }
+
+    setOutputTile(instance, tiles.back());
+    graph.run(GraphStage::Output, progress);
+  }
+
+  // Copies the staged output of a row of tiles (band) to the output image when filtering in-place
+  // The last rows overlap with the input of the next row of tiles, so these are staged again and
+  // copied only after the next row has been processed
+  void UNetFilter::copyOutputBand(int band)
+  {
+    // The band covers the processed region, which may be wider than the region of interest, so only
+    // the columns of the latter are copied to the output
+    const int outputX = hasROI() ? roiX : 0;
+    const int outputW = hasROI() ? roiW : W;
+    const int bandX   = outputX - regionX;
+
+    // The input of the current row has been read, so the last rows of the previous row can be copied
+    if (outputCarryH > 0)
+    {
+      copyImage(outputCarry->newRegion(0, bandX, outputCarryH, outputW),
+                output->newRegion(outputCarryY, outputX, outputCarryH, outputW));
+      outputCarryH = 0;
+    }
+
+    TileInfo tile;
+    getTile(band * tileCountW, tile);
+    if (tile.dstH <= 0)
+      return; // the row does not contribute to the region of interest
+
+    // Get the first input row of the next row of tiles in the same image
+    int nextSrcRow = INT_MAX;
+    if (band % tileCountH < tileCountH - 1)
+    {
+      TileInfo nextTile;
+      getTile((band + 1) * tileCountW, nextTile);
+      nextSrcRow = nextTile.hSrc;
+    }
+
+    const int endRow   = tile.hDst + tile.dstH;
+    const int splitRow = clamp(nextSrcRow, tile.hDst, endRow);
+
+    if (splitRow > tile.hDst)
+    {
+      copyImage(outputBand->newRegion(0, bandX, splitRow - tile.hDst, outputW),
+                output->newRegion(tile.hDst, outputX, splitRow - tile.hDst, outputW));
+    }
+
+    if (endRow > splitRow)
+    {
+      outputCarryY = splitRow;
+      outputCarryH = endRow - splitRow;
+      copyImage(outputBand->newRegion(splitRow - tile.hDst, bandX, outputCarryH, outputW),
+                outputCarry->newRegion(0, bandX, outputCarryH, outputW));
+    }
+  }
+
+  void UNetFilter::copyImage(const Ref<Image>& src, const Ref<Image>& dst)
+  {
+    imageCopy->setSrc(src);
+    imageCopy->setDst(dst);
+
+    if (device->isProfiling())
+      profiler.run(device->getEngine(), *imageCopy, 0);
+    else
+      imageCopy->submit();
+  }
+
+  // Initializes the model for the current parameters
+  // If only estimating, the model is planned into the current state without releasing the committed
+  // model, the weights and the registered memory usage, which must be set aside by the caller
+  void UNetFilter::init(bool estimate)
+  {
+    if (!estimate)
+      cleanup();
+    checkParams();
+
+    // Build the model
+    std::shared_ptr<MappedWeights> newMappedWeights;
+    Data weightsBlob = getWeights(newMappedWeights);
+    TZAMetadata weightsMetadata;
+    std::shared_ptr<TensorMap> constTensors;
+    if (newMappedWeights)
+    {
+      // The mapped weights are parsed only once, but each filter gets its own tensor map
+      constTensors = std::make_shared<TensorMap>(*newMappedWeights->getTensors());
+      weightsMetadata = newMappedWeights->getMetadata();
+    }
+    else
+      constTensors = parseTZA(weightsBlob.ptr, weightsBlob.size, &weightsMetadata);
+    const bool fastMath = quality == Quality::Balanced || quality == Quality::Fast;
+
+    // In fast quality mode, INT8 quantized inference is used where supported by the device if the
+    // weights contain calibrated activation scales
+    const bool quantized = quality == Quality::Fast;
+
+    // Get the network topology from the weights, which do not necessarily contain it (e.g. older
+    // user weights), and derive the network constants from it
+    auto topologyIter = weightsMetadata.find("topology");
+    if (topologyIter != weightsMetadata.end())
+      topology = std::make_shared<NetworkTopology>(topologyIter->second);
+    else
+      topology = std::make_shared<NetworkTopology>(NetworkTopology::getDefault());
+
+    receptiveField = topology->getReceptiveField(*constTensors);
+    minTileAlignment = topology->getAlignment();
+    initTileAlignment();
+
+    // The memory usage is limited by the filter and/or the memory budget of the device
+    const bool memoryLimited = maxMemoryMB >= 0 || device->hasMemoryBudget();
+
+    const int numSubdevices = device->getNumSubdevices();
+    H = output->getH() / batchSize;
     W = output->getW();
-    tileH = round_up(H, minTileAlignment); // add minimum device-independent padding
-    tileW = round_up(W, minTileAlignment);
-    tilePadH = tileH % tileAlignment; // increase the overlap on the bottom to align offsets
-    tilePadW = tileW % tileAlignment; // increase the overlap on the right to align offsets
-    tileCountH = 1;
-    tileCountW = 1;
+    getRegion(regionY, regionX, regionH, regionW);
 
+    // Compute the minimum tile size
+    resetTiles();
     const int minTileDim = max(4*tileOverlap, 768); // MPS has slightly different output using smaller tiles
     const int minTileH = round_up(minTileDim, tileAlignment, tilePadH);
     const int minTileW = round_up(minTileDim, tileAlignment, tilePadW);
 
-    const int maxTileSize = (maxMemoryMB < 0) ? defaultMaxTileSize : INT_MAX;
-    const size_t maxMemoryByteSize = (maxMemoryMB >= 0) ? size_t(maxMemoryMB)*1024*1024 : SIZE_MAX;
-
-    while ((tileCountH * tileCountW) % device->getNumSubdevices() != 0 ||
-           (tileH * tileW) > maxTileSize ||
-           !buildModel(maxMemoryByteSize))
+    // Select the number of tiles to process concurrently on each subdevice
+    // Dividing the image into more tiles causes redundant work in the overlapping regions, so we
+    // process tiles concurrently only if this overhead is small enough. The default maximum tile
+    // size is reduced proportionally to avoid increasing the memory usage.
+    tileConcurrency = 1;
+    for (int k = device->getEngine()->getMaxConcurrentHostTasks(); k > 1; --k)
     {
-      if (tileH > minTileH && tileH > tileW)
+      const int maxTileSize = !memoryLimited ? defaultMaxTileSize / k : INT_MAX;
+
+      resetTiles();
+      while (getNumTiles() % (numSubdevices * k) != 0 || (tileH * tileW) > maxTileSize)
       {
-        const int newTileH = ceil_div(H + (2*tileOverlap+tilePadH) * tileCountH, tileCountH + 1);
-        tileH = clamp(round_up(newTileH, tileAlignment, tilePadH), minTileH, tileH - tileAlignment);
-        tileCountH = max(ceil_div(H - (2*tileOverlap+tilePadH), tileH - (2*tileOverlap+tilePadH)), 1);
+        if (!divideTiles(minTileH, minTileW))
+          break;
       }
-      else if (tileW > minTileW)
+
+      if (getNumTiles() % (numSubdevices * k) == 0 && (tileH * tileW) <= maxTileSize &&
+          getTileOverhead() <= maxConcurrentTileOverhead)
       {
-        const int newTileW = ceil_div(W + (2*tileOverlap+tilePadW) * tileCountW, tileCountW + 1);
-        tileW = clamp(round_up(newTileW, tileAlignment, tilePadW), minTileW, tileW - tileAlignment);
-        tileCountW = max(ceil_div(W - (2*tileOverlap+tilePadW), tileW - (2*tileOverlap+tilePadW)), 1);
+        tileConcurrency = k;
+        break;
       }
-      else
+    }
+
+    // Get the shared final weights for each subdevice
+    // Filters using the same model share their final weights, which are kept in memory only once for
+    // all of them. Built-in weights are identified by their address and are kept until the device is
+    // released, while user weights are identified by their contents.
+    const bool builtinWeights = !userWeightsBlob && !newMappedWeights;
+    uint64_t weightsHash = newMappedWeights ? newMappedWeights->getHash() : userWeightsHash;
+    if (userWeightsBlob && dirtyWeightsHash)
+    {
+      weightsHash = hashBytes(userWeightsBlob.ptr, userWeightsBlob.size);
+      if (!estimate)
+      {
+        userWeightsHash = weightsHash;
+        dirtyWeightsHash = false;
+      }
+    }
+
+    std::vector<std::shared_ptr<SharedWeights>> newSharedWeights(numSubdevices);
+    for (int i = 0; i < numSubdevices; ++i)
+    {
+      Engine* engine = device->getEngine(i);
+      newSharedWeights[i] = SharedWeights::get(engine, weightsBlob, builtinWeights, weightsHash,
+                                               newMappedWeights);
+      if (builtinWeights && !estimate)
+        engine->getSubdevice()->retainWeights(newSharedWeights[i]);
+    }
+
+    // The previous weights are released only now, so unchanged weights remain in memory
+    if (!estimate)
+    {
+      sharedWeights = newSharedWeights;
+      mappedWeights = newMappedWeights;
+    }
+    const void* weightsKey = newSharedWeights[0].get();
+
+    // The shared weights may be used by other devices as well, thus we have to lock them while
+    // building the model (in a consistent order to avoid deadlocks)
+    std::vector<SharedWeights*> lockedWeights;
+    for (const auto& weights : newSharedWeights)
+      lockedWeights.push_back(weights.get());
+    std::sort(lockedWeights.begin(), lockedWeights.end());
+    lockedWeights.erase(std::unique(lockedWeights.begin(), lockedWeights.end()), lockedWeights.end());
+    std::vector<std::unique_lock<std::mutex>> weightsLocks;
+    for (SharedWeights* weights : lockedWeights)
+      weightsLocks.emplace_back(weights->getMutex());
+
+    // The weights not found in memory may be loaded from the persistent weights cache
+    std::unique_ptr<WeightsCache> weightsCache;
+    if (!estimate && !device->getWeightsCacheDir().empty())
+      weightsCache.reset(new WeightsCache(device.get(), device->getWeightsCacheDir(), weightsBlob));
+
+    std::vector<std::shared_ptr<TensorMap>> cachedConstTensors(numSubdevices);
+    std::shared_ptr<TensorMap> newCachedConstTensors; // weights to save to the persistent cache
+
+    for (int i = 0; i < numSubdevices; ++i)
+    {
+      Engine* engine = device->getEngine(i);
+      cachedConstTensors[i] = newSharedWeights[i]->getTensors();
+
+      if (weightsCache && cachedConstTensors[i]->empty() &&
+          !weightsCache->load(engine, *cachedConstTensors[i]) && !newCachedConstTensors)
+        newCachedConstTensors = cachedConstTensors[i];
+    }
+
+    const int numInstances = numSubdevices * tileConcurrency;
+    for (int i = 0; i < numInstances; ++i)
+    {
+      Engine* engine = device->getEngine(i % numSubdevices);
+      instances.emplace_back();
+      instances.back().graph =
+        makeRef<Graph>(engine, constTensors, cachedConstTensors[i % numSubdevices], fastMath, quantized);
+      instances.back().inputTransferFunc  = newTransferFunc();
+      instances.back().outputTransferFunc = newTransferFunc();
+    }
+
+    // Try to divide the image into tiles until the memory usage gets below the specified threshold
+    // and the total number of tiles in the batch is a multiple of the number of model instances
+    resetTiles();
+
+    const int maxTileSize = !memoryLimited ? defaultMaxTileSize / tileConcurrency : INT_MAX;
+    const size_t maxMemoryByteSize = min((maxMemoryMB >= 0) ? size_t(maxMemoryMB)*1024*1024 : SIZE_MAX,
+                                         device->getMaxFilterMemoryByteSize(this, weightsKey));
+
+    while (getNumTiles() % numInstances != 0 ||
+           (tileH * tileW) > maxTileSize ||
+           !buildModel(maxMemoryByteSize, estimate))
+    {
+      if (!divideTiles(minTileH, minTileW))
       {
         // Cannot divide further
-        if (!buildModel())
+        if (!buildModel(SIZE_MAX, estimate))
           throw std::runtime_error("could not build filter model");
         break;
       }
     }
 
+    // When only estimating, the graphs are not finalized, so the model cannot be used
+    if (estimate)
+    {
+      instances.clear();
+      return;
+    }
+
+    // Save the convolution parameters tuned while building the model only once
+    for (int i = 0; i < numSubdevices; ++i)
+      device->getEngine(i)->saveTuning();
+
+    // Register the memory kept by the filter, which is not shared with other filters
+    // In streaming mode, the scratch is not shared either
+    device->setFilterMemoryUsage(this, streaming ? totalScratchByteSize : 0,
+                                 weightsKey, totalWeightsByteSize);
+
+    // Save the final weights to the persistent cache if they were not loaded from there
+    if (newCachedConstTensors)
+      weightsCache->save(*newCachedConstTensors);
+
     if (device->isVerbose(2))
     {
       std::cout << "Image size: " << W << "x" << H << std::endl;
+      if (hasROI())
+        std::cout << "Region    : " << regionW << "x" << regionH << " at " << regionX << "," << regionY << std::endl;
+      std::cout << "Batch size: " << batchSize << std::endl;
+      std::cout << "Tile batch: " << tileBatchSize << std::endl;
       std::cout << "Tile size : " << tileW << "x" << tileH << std::endl;
       std::cout << "Tile count: " << tileCountW << "x" << tileCountH << std::endl;
+      std::cout << "Concurrent: " << tileConcurrency << std::endl;
+      std::cout << "Pipelined : " << (pipelined ? "true" : "false") << std::endl;
       std::cout << "In-place  : " << (inplace ? "true" : "false") << std::endl;
     }
   }
 
+  // Checks whether the output overlaps any of the input images
+  bool UNetFilter::isInplace() const
+  {
+    return output &&
+           ((color  && output->overlaps(*color))  ||
+            (albedo && output->overlaps(*albedo)) ||
+            (normal && output->overlaps(*normal)));
+  }
+
+  // Gets the region of the image which must be processed to denoise the region of interest
+  void UNetFilter::getRegion(int& y, int& x, int& h, int& w) const
+  {
+    if (!hasROI())
+    {
+      y = 0;
+      x = 0;
+      h = H;
+      w = W;
+      return;
+    }
+
+    if (roiX < 0 || roiY < 0 || roiX + roiW > W || roiY + roiH > H)
+      throw Exception(Error::InvalidOperation, "region of interest is out of bounds");
+
+    // Extend the region of interest by the tile overlap, which covers the receptive field, and
+    // align the origin to get the same output as when denoising the whole image
+    y = max(roiY - tileOverlap, 0) / tileAlignment * tileAlignment;
+    x = max(roiX - tileOverlap, 0) / tileAlignment * tileAlignment;
+    h = min(roiY + roiH + tileOverlap, H) - y;
+    w = min(roiX + roiW + tileOverlap, W) - x;
+  }
+
+  // Small images of a batch can be packed into the same tile, so a single execution of the network
+  // processes all of them, which amortizes the overhead of the operations. This requires the same
+  // input scale for all images, and is not supported for in-place filtering, which stages the output
+  // of each row of tiles.
+  bool UNetFilter::canPackTiles() const
+  {
+    return batchSize > 1 && !inplace && !(hdr && math::isnan(inputScale));
+  }
+
+  // Returns the row offset between the images packed into a tile, which are separated by zero rows
+  // to avoid affecting each other's output, like the overlap between tiles
+  int UNetFilter::getPackedImageStride() const
+  {
+    return round_up(regionH, tileAlignment) + tileOverlap;
+  }
+
+  // Returns the number of tiles of all images in the batch
+  int UNetFilter::getNumTiles() const
+  {
+    return ceil_div(batchSize, tileBatchSize) * tileCountH * tileCountW;
+  }
+
+  void UNetFilter::setTileBatchSize(int newTileBatchSize)
+  {
+    tileBatchSize = newTileBatchSize;
+    tileH = (tileBatchSize - 1) * getPackedImageStride() + round_up(regionH, minTileAlignment);
+    tilePadH = tileH % tileAlignment;
+  }
+
+  void UNetFilter::resetTiles()
+  {
+    tileH = round_up(regionH, minTileAlignment); // add minimum device-independent padding
+    tileW = round_up(regionW, minTileAlignment);
+    tilePadH = tileH % tileAlignment; // increase the overlap on the bottom to align offsets
+    tilePadW = tileW % tileAlignment; // increase the overlap on the right to align offsets
+    tileCountH = 1;
+    tileCountW = 1;
+    setTileBatchSize(canPackTiles() ? batchSize : 1); // start with all images in the same tile
+  }
+
+  // Tries to divide the image into more tiles, returns false if the tiles cannot be divided further
+  // Images packed into the same tile are divided first into more tiles
+  bool UNetFilter::divideTiles(int minTileH, int minTileW)
+  {
+    if (tileBatchSize > 1)
+      setTileBatchSize(tileBatchSize / 2);
+    else if (tileH > minTileH && tileH > tileW)
+    {
+      const int newTileH = ceil_div(regionH + (2*tileOverlap+tilePadH) * tileCountH, tileCountH + 1);
+      tileH = clamp(round_up(newTileH, tileAlignment, tilePadH), minTileH, tileH - tileAlignment);
+      tileCountH = max(ceil_div(regionH - (2*tileOverlap+tilePadH), tileH - (2*tileOverlap+tilePadH)), 1);
+    }
+    else if (tileW > minTileW)
+    {
+      const int newTileW = ceil_div(regionW + (2*tileOverlap+tilePadW) * tileCountW, tileCountW + 1);
+      tileW = clamp(round_up(newTileW, tileAlignment, tilePadW), minTileW, tileW - tileAlignment);
+      tileCountW = max(ceil_div(regionW - (2*tileOverlap+tilePadW), tileW - (2*tileOverlap+tilePadW)), 1);
+    }
+    else
+      return false;
+
+    return true;
+  }
+
+  // Returns the relative amount of redundant work caused by the overlaps between the tiles
+  double UNetFilter::getTileOverhead() const
+  {
+    // The zero rows between the images packed into a tile are redundant work as well
+    const double tiledH = (tileBatchSize > 1)
+      ? double(tileH) / tileBatchSize
+      : regionH + (tileCountH - 1) * (2*tileOverlap + tilePadH);
+    const double tiledW = regionW + (tileCountW - 1) * (2*tileOverlap + tilePadW);
+    return (tiledH * tiledW) / (double(regionH) * double(regionW)) - 1.;
+  }
+
   void UNetFilter::cleanup()
   {
     instances.clear();
-    transferFunc.reset();
+    topology.reset();
+    device->removeFilterMemoryUsage(this);
+    totalScratchByteSize = 0;
+    totalWeightsByteSize = 0;
     autoexposure.reset();
+    autoexposureDsts.clear();
     imageCopy.reset();
-    outputTemp.reset();
+    outputBand.reset();
+    outputCarry.reset();
   }
 
   void UNetFilter::checkParams()
@@ -374,6 +1062,9 @@ OIDN_NAMESPACE_BEGIN
         (normal && (normal->getW() != output->getW() || normal->getH() != output->getH())))
       throw Exception(Error::InvalidOperation, "image size mismatch");
 
+    if (output->getH() % batchSize != 0)
+      throw Exception(Error::InvalidOperation, "image height is not a multiple of the batch size");
+
     if (directional && (hdr || srgb))
       throw Exception(Error::InvalidOperation, "directional and hdr/srgb modes cannot be enabled at the same time");
     if (hdr && srgb)
@@ -391,27 +1082,55 @@ OIDN_NAMESPACE_BEGIN
     }
   }
 
-  Data UNetFilter::getWeights()
+  // Selects the weights to use for the current parameters, and maps the user weights file if specified
+  // The filter state is not changed, so the committed model keeps its weights until reinitialized
+  Data UNetFilter::getWeights(std::shared_ptr<MappedWeights>& newMappedWeights) const
+  {
+    // In fast quality mode, prefer the weights of the smaller networks if available for the
+    // specified set of features, but fall back to the default weights otherwise
+    Data weightsBlob;
+    if (quality == Quality::Fast)
+      weightsBlob = getWeights(smallWeightsBlobs);
+    if (!weightsBlob)
+      weightsBlob = getWeights(weightsBlobs);
+
+    // User weights passed as a blob take precedence over a weights file
+    newMappedWeights.reset();
+    if (userWeightsBlob)
+      weightsBlob = userWeightsBlob;
+    else if (!userWeightsPath.empty())
+    {
+      newMappedWeights = MappedWeights::get(userWeightsPath);
+      weightsBlob = newMappedWeights->getBlob();
+    }
+
+    if (!weightsBlob)
+      throw Exception(Error::InvalidOperation, "unsupported combination of input features");
+
+    return weightsBlob;
+  }
+
+  // Selects the weights to use from a set of weights, returns an empty blob if not available
+  Data UNetFilter::getWeights(const WeightsBlobs& blobs) const
   {
-    // Select the weights to use
     Data weightsBlob;
 
     if (color)
     {
       if (!albedo && !normal)
       {
-        weightsBlob = directional ? weightsBlobs.dir : (hdr ? weightsBlobs.hdr : weightsBlobs.ldr);
+        weightsBlob = directional ? blobs.dir : (hdr ? blobs.hdr : blobs.ldr);
       }
       else if (albedo && !normal)
       {
-        weightsBlob = hdr ? weightsBlobs.hdr_alb : weightsBlobs.ldr_alb;
+        weightsBlob = hdr ? blobs.hdr_alb : blobs.ldr_alb;
       }
       else if (albedo && normal)
       {
         if (cleanAux)
-          weightsBlob = hdr ? weightsBlobs.hdr_calb_cnrm : weightsBlobs.ldr_calb_cnrm;
+          weightsBlob = hdr ? blobs.hdr_calb_cnrm : blobs.ldr_calb_cnrm;
         else
-          weightsBlob = hdr ? weightsBlobs.hdr_alb_nrm : weightsBlobs.ldr_alb_nrm;
+          weightsBlob = hdr ? blobs.hdr_alb_nrm : blobs.ldr_alb_nrm;
       }
     }
     else
@@ -421,13 +1140,13 @@ OIDN_NAMESPACE_BEGIN
       {
         if (hdr)
           throw Exception(Error::InvalidOperation, "hdr mode is not supported for albedo filtering");
-        weightsBlob = weightsBlobs.alb;
+        weightsBlob = blobs.alb;
       }
       else if (!albedo && normal)
       {
         if (hdr || srgb)
           throw Exception(Error::InvalidOperation, "hdr and srgb modes are not supported for normal filtering");
-        weightsBlob = weightsBlobs.nrm;
+        weightsBlob = blobs.nrm;
       }
       else
       {
@@ -435,17 +1154,12 @@ OIDN_NAMESPACE_BEGIN
       }
     }
 
-    if (userWeightsBlob)
-      weightsBlob = userWeightsBlob;
-
-    if (!weightsBlob)
-      throw Exception(Error::InvalidOperation, "unsupported combination of input features");
-
     return weightsBlob;
   }
 
   // Tries to build the model without exceeding the specified amount of memory
-  bool UNetFilter::buildModel(size_t maxMemoryByteSize)
+  // If only estimating, the memory usage is computed but the model is not finalized
+  bool UNetFilter::buildModel(size_t maxMemoryByteSize, bool estimate)
   {
     // If the image size is zero, there is nothing else to do
     if (H <= 0 || W <= 0)
@@ -460,50 +1174,73 @@ OIDN_NAMESPACE_BEGIN
     // Create global operations (not part of any model instance or graph)
     Ref<Autoexposure> autoexposure;
     if (hdr)
-      autoexposure = device->getEngine()->newAutoexposure(color->getDesc());
+      autoexposure = device->getEngine()->newAutoexposure(ImageDesc(color->getFormat(), W, H));
 
     const bool snorm = directional || (!color && normal);
     TensorDims inputDims{inputC, tileH, tileW};
     size_t totalMemoryByteSize = 0;
 
-    // Create model instances for each subdevice
-    for (int instanceID = 0; instanceID < device->getNumSubdevices(); ++instanceID)
+    // Create the model instances
+    const int numSubdevices = device->getNumSubdevices();
+    const int numInstances  = int(instances.size());
+
+    // In streaming mode, the processed auxiliary features can be kept in the input tensors of the
+    // instances if each tile is always processed by the same instance
+    keepInput = streaming && color && (albedo || normal) &&
+                getNumTiles() == numInstances;
+
+    // If there are multiple tiles processed sequentially, pipeline them by overlapping the input and
+    // output processing with the convolutions, which requires the input and output tensors of the
+    // graph to be persistent (not supported when profiling because it measures each op separately)
+    pipelined = numInstances == 1 && getNumTiles() > 1 &&
+                device->getEngine()->canOverlapHostTasks() && !device->isProfiling();
+
+    for (int instanceID = 0; instanceID < numInstances; ++instanceID)
     {
       auto& instance = instances[instanceID];
       auto& graph = instance.graph;
 
       // Create the model graph
       auto inputProcess = graph->addInputProcess("input", inputDims,
-                                                 transferFunc, hdr, snorm);
-
-      auto encConv0 = graph->addConv("enc_conv0", inputProcess, Activation::ReLU);
+                                                 instance.inputTransferFunc, hdr, snorm,
+                                                 keepInput || pipelined);
 
-      auto pool1 = graph->addConv("enc_conv1", encConv0, Activation::ReLU, PostOp::Pool);
+      // Add the layers of the network topology, the outputs of which are referenced by name
+      std::unordered_map<std::string, Ref<Op>> layerOps;
+      layerOps["input"] = inputProcess;
 
-      auto pool2 = graph->addConv("enc_conv2", pool1, Activation::ReLU, PostOp::Pool);
-
-      auto pool3 = graph->addConv("enc_conv3", pool2, Activation::ReLU, PostOp::Pool);
-
-      auto pool4 = graph->addConv("enc_conv4", pool3, Activation::ReLU, PostOp::Pool);
-
-      auto encConv5a = graph->addConv("enc_conv5a", pool4, Activation::ReLU);
-
-      auto upsample4 = graph->addConv("enc_conv5b", encConv5a, Activation::ReLU, PostOp::Upsample);
-      auto decConv4a = graph->addConcatConv("dec_conv4a", upsample4, pool3, Activation::ReLU);
-
-      auto upsample3 = graph->addConv("dec_conv4b", decConv4a, Activation::ReLU, PostOp::Upsample);
-      auto decConv3a = graph->addConcatConv("dec_conv3a", upsample3, pool2, Activation::ReLU);
+      const auto& layers = topology->getLayers();
+      for (size_t i = 0; i < layers.size(); ++i)
+      {
+        const auto& layer = layers[i];
+        Ref<Op> srcOp = layerOps[layer.src];
 
-      auto upsample2 = graph->addConv("dec_conv3b", decConv3a, Activation::ReLU, PostOp::Upsample);
-      auto decConv2a = graph->addConcatConv("dec_conv2a", upsample2, pool1, Activation::ReLU);
+        if (!layer.skip.empty())
+        {
+          // Skip connection (the concatenated convolution does not support post-ops)
+          Ref<Op> op = graph->addConcatConv(layer.name, srcOp, layerOps[layer.skip], layer.activation);
+          if (layer.postOp == PostOp::Pool)
+            op = graph->addPool(layer.name + "_pool", op);
+          else if (layer.postOp == PostOp::Upsample)
+            op = graph->addUpsample(layer.name + "_upsample", op);
+          layerOps[layer.name] = op;
+          continue;
+        }
 
-      auto upsample1 = graph->addConv("dec_conv2b", decConv2a, Activation::ReLU, PostOp::Upsample);
-      auto decConv1a = graph->addConcatConv("dec_conv1a", upsample1, inputProcess, Activation::ReLU);
-      auto decConv1b = graph->addConv("dec_conv1b", decConv1a, Activation::ReLU);
+        // The full resolution convolutions which are not followed by a skip connection are chained,
+        // so their outputs do not have to be stored at full size if the engine supports it
+        std::vector<std::string> chainNames{layer.name};
+        while (layers[i].level == 0 && topology->isChainable(i))
+          chainNames.push_back(layers[++i].name);
 
-      auto decConv0 = graph->addConv("dec_conv0", decConv1b, Activation::ReLU);
+        Ref<Op> op = (chainNames.size() > 1)
+          ? graph->addConvChain(chainNames, srcOp, layer.activation, layers[i].postOp)
+          : graph->addConv(layer.name, srcOp, layer.activation, layer.postOp);
+        layerOps[layers[i].name] = op;
+      }
 
-      auto outputProcess = graph->addOutputProcess("output", decConv0, transferFunc, hdr, snorm);
+      auto outputProcess = graph->addOutputProcess("output", layerOps[layers.back().name],
+                                                   instance.outputTransferFunc, hdr, snorm, pipelined);
 
       // Check whether all operations in the graph are supported
       if (!graph->isSupported())
@@ -517,59 +1254,95 @@ OIDN_NAMESPACE_BEGIN
       size_t scratchByteSize = graphScratchByteSize;
 
       // Allocate scratch for global operations
+      // If the graph keeps its input, the scratch of the global operations must not overlap with it
+      size_t autoexposureScratchByteOffset = SIZE_MAX;
       if (instanceID == 0 && hdr)
-        scratchByteSize = max(scratchByteSize, autoexposure->getScratchByteSize());
+      {
+        if (keepInput && autoexposure->getScratchByteSize() > 0)
+        {
+          autoexposureScratchByteOffset = scratchByteSize;
+          scratchByteSize += autoexposure->getScratchByteSize();
+        }
+        else
+          scratchByteSize = max(scratchByteSize, autoexposure->getScratchByteSize());
+      }
 
       scratchByteSize = round_up(scratchByteSize, memoryAlignment);
 
-      // If doing in-place _tiled_ filtering, allocate a temporary output image
-      ImageDesc outputTempDesc(output->getFormat(), W, H);
-      size_t outputTempByteOffset = SIZE_MAX;
+      // If doing in-place _tiled_ filtering, allocate a staging image for the output of a row of
+      // tiles, and another one for its last rows which are also the input of the next row of tiles
+      // These cover the whole processed region, thus moving or resizing the region of interest
+      // within the same region does not require reallocating them
+      ImageDesc outputBandDesc(output->getFormat(), regionW, tileH);
+      ImageDesc outputCarryDesc(output->getFormat(), regionW, tileOverlap);
+      size_t outputBandByteOffset = SIZE_MAX;
+      size_t outputCarryByteOffset = SIZE_MAX;
       if (instanceID == 0 && inplace && (tileCountH * tileCountW) > 1)
       {
-        outputTempByteOffset = scratchByteSize;
-        scratchByteSize += round_up(outputTempDesc.getByteSize(), memoryAlignment);
+        outputBandByteOffset = scratchByteSize;
+        scratchByteSize += round_up(outputBandDesc.getByteSize(), memoryAlignment);
+        outputCarryByteOffset = scratchByteSize;
+        scratchByteSize += round_up(outputCarryDesc.getByteSize(), memoryAlignment);
       }
 
-      // If denoising in HDR mode, allocate a tensor for the autoexposure result
+      // If denoising in HDR mode, allocate the autoexposure result for each image in the batch
       size_t autoexposureDstOffset = SIZE_MAX;
       if (instanceID == 0 && hdr)
       {
         autoexposureDstOffset = scratchByteSize;
-        scratchByteSize += round_up(sizeof(float), memoryAlignment);
+        scratchByteSize += round_up(sizeof(float) * batchSize, memoryAlignment);
       }
 
       // Check the total memory usage
       if (instanceID == 0)
       {
-        totalMemoryByteSize = (scratchByteSize + graph->getPrivateByteSize()) +
-          (graphScratchByteSize + graph->getPrivateByteSize()) * (device->getNumSubdevices() - 1);
+        // Instances on the same subdevice share the cached weights
+        const int numWeightCopies = numSubdevices;
+        totalScratchByteSize = scratchByteSize + graphScratchByteSize * (numInstances - 1);
+        totalWeightsByteSize = graph->getPrivateByteSize() * numWeightCopies;
+        totalMemoryByteSize  = totalScratchByteSize + totalWeightsByteSize;
 
-        if (totalMemoryByteSize > maxMemoryByteSize)
+        if (totalMemoryByteSize > maxMemoryByteSize || estimate)
         {
           resetModel();
-          return false;
+          return estimate && totalMemoryByteSize <= maxMemoryByteSize;
         }
       }
 
       // Allocate the scratch buffer
-      auto scratchArena = device->getSubdevice(instanceID)->newScratchArena(scratchByteSize);
+      // Instances processing tiles concurrently on the same subdevice must not share scratch memory
+      // In streaming mode, the scratch is not shared with other filters either to preserve the
+      // data reused by the next execution
+      const int slot = instanceID / numSubdevices;
+      std::string scratchName = (slot > 0) ? ("tile" + toString(slot)) : "";
+      if (streaming)
+        scratchName = "stream" + toString(reinterpret_cast<uintptr_t>(this)) + "_" + toString(slot);
+      auto scratchArena = device->getSubdevice(instanceID % numSubdevices)->newScratchArena(scratchByteSize, scratchName);
       auto scratch = scratchArena->newBuffer(scratchByteSize);
 
       // Set the scratch buffer for the graph and the global operations
       graph->setScratch(scratch);
       if (instanceID == 0 && hdr)
       {
-        autoexposure->setScratch(scratch);
-        autoexposure->setDst(makeRef<Record<float>>(scratch, autoexposureDstOffset));
+        if (autoexposureScratchByteOffset < SIZE_MAX)
+          autoexposure->setScratch(scratch->newBuffer(autoexposure->getScratchByteSize(),
+                                                      autoexposureScratchByteOffset));
+        else
+          autoexposure->setScratch(scratch);
+        for (int b = 0; b < batchSize; ++b)
+          autoexposureDsts.push_back(makeRef<Record<float>>(scratch, autoexposureDstOffset + b * sizeof(float)));
+        autoexposure->setDst(autoexposureDsts[0]);
       }
 
       // Finalize the network
       graph->finalize();
 
-      // Create the temporary output image
-      if (instanceID == 0 && outputTempByteOffset < SIZE_MAX)
-        outputTemp = scratch->newImage(outputTempDesc, outputTempByteOffset);
+      // Create the output staging images
+      if (instanceID == 0 && outputBandByteOffset < SIZE_MAX)
+      {
+        outputBand  = scratch->newImage(outputBandDesc, outputBandByteOffset);
+        outputCarry = scratch->newImage(outputCarryDesc, outputCarryByteOffset);
+      }
 
       instance.inputProcess  = inputProcess;
       instance.outputProcess = outputProcess;
@@ -580,10 +1353,10 @@ OIDN_NAMESPACE_BEGIN
       autoexposure->finalize();
     this->autoexposure = autoexposure;
 
-    if (outputTemp)
+    if (outputBand)
     {
       imageCopy = device->getEngine()->newImageCopy();
-      imageCopy->setSrc(outputTemp);
+      imageCopy->setSrc(outputBand);
       imageCopy->finalize();
     }
 
@@ -596,6 +1369,9 @@ OIDN_NAMESPACE_BEGIN
 
   void UNetFilter::resetModel()
   {
+    keepInput = false;
+    pipelined = false;
+
     for (auto& instance : instances)
     {
       instance.graph->clear();
@@ -604,8 +1380,10 @@ OIDN_NAMESPACE_BEGIN
     }
 
     autoexposure.reset();
+    autoexposureDsts.clear();
     imageCopy.reset();
-    outputTemp.reset();
+    outputBand.reset();
+    outputCarry.reset();
   }
 
 OIDN_NAMESPACE_END
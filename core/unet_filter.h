@@ -8,6 +8,9 @@
 #include "color.h"
 #include "autoexposure.h"
 #include "image_copy.h"
+#include "network_topology.h"
+#include "mapped_weights.h"
+#include "shared_weights.h"
 
 OIDN_NAMESPACE_BEGIN
 
@@ -18,10 +21,13 @@ OIDN_NAMESPACE_BEGIN
     void setData(const std::string& name, const Data& data) override;
     void updateData(const std::string& name) override;
     void unsetData(const std::string& name) override;
+    Data getData(const std::string& name) override;
     void setInt(const std::string& name, int value) override;
     int getInt(const std::string& name) override;
     void setFloat(const std::string& name, float value) override;
     float getFloat(const std::string& name) override;
+    void setString(const std::string& name, const std::string& value) override;
+    const char* getString(const std::string& name) override;
 
     void commit() override;
     void execute(SyncMode sync) override;
@@ -30,11 +36,12 @@ OIDN_NAMESPACE_BEGIN
     explicit UNetFilter(const Ref<Device>& device);
     virtual std::shared_ptr<TransferFunction> newTransferFunc() = 0;
 
-    // Network constants
-    // TODO: autodetect these values from the model
-    static constexpr int receptiveField   = 174; // receptive field in pixels
-    static constexpr int minTileAlignment = 16;  // required spatial alignment in pixels (padding may be necessary)
+    // Network constants of the built-in weights, which are used until the actual values are
+    // derived from the topology of the selected weights
+    static constexpr int defaultReceptiveField   = 174; // receptive field in pixels
+    static constexpr int defaultMinTileAlignment = 16;  // required spatial alignment in pixels (padding may be necessary)
     static constexpr int defaultMaxTileSize = 2160*2160; // default maximum number of pixels per tile
+    static constexpr double maxConcurrentTileOverhead = 0.25; // max relative redundant work of concurrent tiles
 
     // Images
     Ref<Image> color;
@@ -52,9 +59,21 @@ OIDN_NAMESPACE_BEGIN
     bool cleanAux = false;
     int maxMemoryMB = -1;     // maximum memory usage limit in MBs, disabled if < 0
     int prevMaxMemoryMB = -1; // maximum memory usage limit in MBs from the previous commit
+    int batchSize = 1;        // number of same-sized images stacked vertically in each image
+    bool streaming = false;   // reuse the results of the previous execution for unchanged images
+
+    // Region of interest to denoise in each image, the whole image is denoised if it is empty
+    int roiX = 0;
+    int roiY = 0;
+    int roiW = 0;
+    int roiH = 0;
+
+    // Images whose contents changed since the previous execution (used only in streaming mode)
+    bool dirtyColor = true; // color or output
+    bool dirtyAux   = true; // albedo or normal
 
     // Weights
-    struct
+    struct WeightsBlobs
     {
       Data hdr;
       Data hdr_alb;
@@ -67,47 +86,128 @@ OIDN_NAMESPACE_BEGIN
       Data dir;
       Data alb;
       Data nrm;
-    } weightsBlobs;
+    };
+    WeightsBlobs weightsBlobs;
+    WeightsBlobs smallWeightsBlobs; // weights of smaller networks for fast quality mode (optional)
     Data userWeightsBlob;
+    uint64_t userWeightsHash = 0;                 // hash of the contents of the user weights blob
+    bool dirtyWeightsHash = true;
+    std::string userWeightsPath;                  // path of the user weights file to map
+    std::shared_ptr<MappedWeights> mappedWeights; // mapped user weights file (shared with other filters)
 
   private:
-    void init();
+    // Memory usage and tiling of the model
+    struct Estimate
+    {
+      size_t scratchByteSize; // scratch memory of all instances
+      size_t weightsByteSize; // private weight memory of all instances
+      int tileH, tileW;
+      int tileCountH, tileCountW;
+    };
+
+    void setInputScale(float value);
+    void init(bool estimate = false);
+    Estimate estimate();
     void cleanup();
     void checkParams();
-    Data getWeights();
-    bool buildModel(size_t maxMemoryByteSize = std::numeric_limits<size_t>::max());
+    bool isInplace() const;
+    Data getWeights(std::shared_ptr<MappedWeights>& newMappedWeights) const;
+    Data getWeights(const WeightsBlobs& blobs) const;
+    void initTileAlignment();
+    bool buildModel(size_t maxMemoryByteSize = std::numeric_limits<size_t>::max(), bool estimate = false);
     void resetModel();
 
-    // Image dimensions
-    int H = 0;             // image height
-    int W = 0;             // image width
-    int tileH = 0;         // tile height
-    int tileW = 0;         // tile width
-    int tilePadH = 0;      // tile padding in H dimension (may be required for alignment)
-    int tilePadW = 0;      // tile padding in W dimension (may be required for alignment)
-    int tileCountH = 1;    // number of tiles in H dimension
-    int tileCountW = 1;    // number of tiles in W dimension
-    int tileOverlap = 0;   // device-dependent spatial overlap between tiles in pixels
-    int tileAlignment = 1; // device-dependent spatial tile offset alignment in pixels
-    bool inplace = false;  // indicates whether input and output buffers overlap
-
-    // Per-engine model instance
+    // Region of interest
+    bool hasROI() const { return roiW > 0 && roiH > 0; }
+    void getRegion(int& y, int& x, int& h, int& w) const;
+
+    // Model instance for processing a tile on a subdevice
+    // The instance with index i belongs to subdevice i % numSubdevices
     struct Instance
     {
       Ref<Graph> graph;
       Ref<InputProcess> inputProcess;
       Ref<OutputProcess> outputProcess;
+      // The input scale may differ between batch images, and the output of a tile may be processed
+      // after the input of the next tile when pipelining
+      std::shared_ptr<TransferFunction> inputTransferFunc;
+      std::shared_ptr<TransferFunction> outputTransferFunc;
     };
 
+    // Position and size of a tile in the batch
+    struct TileInfo
+    {
+      int b;                          // image index in the batch
+      int numImages;                  // number of images packed into the tile (stacked vertically)
+      int hSrc, wSrc;                 // input tile position (including overlaps)
+      int srcH, srcW;                 // input tile size (including overlaps)
+      int alignOffsetH, alignOffsetW; // position in the tile buffer
+      int hDst, wDst;                 // output tile position (clipped to the region of interest)
+      int dstH, dstW;                 // output tile size
+    };
+
+    // Tiling
+    bool canPackTiles() const;
+    int getPackedImageStride() const;
+    int getNumTiles() const;
+    void setTileBatchSize(int newTileBatchSize);
+    void resetTiles();
+    bool divideTiles(int minTileH, int minTileW);
+    double getTileOverhead() const;
+    bool getTile(int tileIndex, TileInfo& tile) const;
+    void setInputTile(Instance& instance, const TileInfo& tile);
+    void setOutputTile(Instance& instance, const TileInfo& tile);
+    void runTile(int tileIndex, int instanceID);
+    void runTiles(int tileBegin, int tileEnd);
+    void runPipelinedTiles(int tileBegin, int tileEnd);
+    void copyOutputBand(int band);
+    void copyImage(const Ref<Image>& src, const Ref<Image>& dst);
+
+    // Image dimensions
+    int H = 0;               // image height (of a single image in the batch)
+    int W = 0;               // image width
+    int regionY = 0;         // origin of the processed region (the region of interest extended by
+    int regionX = 0;         // the tile overlap, or the whole image)
+    int regionH = 0;         // processed region height
+    int regionW = 0;         // processed region width
+    int tileH = 0;           // tile height
+    int tileW = 0;           // tile width
+    int tilePadH = 0;        // tile padding in H dimension (may be required for alignment)
+    int tilePadW = 0;        // tile padding in W dimension (may be required for alignment)
+    int tileCountH = 1;      // number of tiles in H dimension
+    int tileCountW = 1;      // number of tiles in W dimension
+    int tileBatchSize = 1;   // maximum number of images of the batch packed into a tile
+    int tileOverlap = 0;     // device-dependent spatial overlap between tiles in pixels
+    int tileAlignment = 1;   // device-dependent spatial tile offset alignment in pixels
+    int tileConcurrency = 1; // number of tiles processed concurrently on each subdevice
+    bool inplace = false;    // indicates whether input and output buffers overlap
+    bool keepInput = false;  // each instance always processes the same tile and keeps its input (streaming)
+    bool pipelined = false;  // the input/output processing of adjacent tiles overlaps with the convolutions
+
     // Model
+    std::shared_ptr<NetworkTopology> topology;
+    int receptiveField = defaultReceptiveField;     // receptive field of the network in pixels
+    int minTileAlignment = defaultMinTileAlignment; // spatial alignment required by the network in pixels
     std::vector<Instance> instances;
-    std::shared_ptr<TransferFunction> transferFunc;
+    std::vector<std::shared_ptr<SharedWeights>> sharedWeights; // final weights of each subdevice
+    size_t totalScratchByteSize = 0; // scratch memory of all instances
+    size_t totalWeightsByteSize = 0; // private weight memory of all instances
     Ref<Autoexposure> autoexposure;
+    std::vector<Ref<Record<float>>> autoexposureDsts; // autoexposure result for each batch image
     // In-place tiled filtering
+    // The output of each row of tiles is staged and copied to the output image only when the next
+    // row of tiles does not need it as input anymore
     Ref<ImageCopy> imageCopy;
-    Ref<Image> outputTemp;
+    Ref<Image> outputBand;  // staged output of the current row of tiles
+    Ref<Image> outputCarry; // staged last output rows of the previous row of tiles
+    int outputCarryY = 0;   // position of the staged last output rows in the output image
+    int outputCarryH = 0;   // number of staged last output rows
 
     Progress progress;
+
+    // Profiling
+    Profiler profiler;
+    std::string profileTrace; // last queried profile in Chrome trace format
   };
 
 OIDN_NAMESPACE_END
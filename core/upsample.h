@@ -25,6 +25,8 @@ OIDN_NAMESPACE_BEGIN
     void setSrc(const Ref<Tensor>& src);
     void setDst(const Ref<Tensor>& dst);
 
+    size_t getNumBytes() const override { return srcDesc.getByteSize() + dstDesc.getByteSize(); }
+
   protected:
     virtual void updateSrc() {}
     virtual void updateDst() {}
@@ -0,0 +1,275 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "weights_cache.h"
+#include "mapped_file.h"
+#include "atomic_file.h"
+#include "hash.h"
+#include "device.h"
+#include <iomanip>
+#include <map>
+
+OIDN_NAMESPACE_BEGIN
+
+  namespace
+  {
+    constexpr uint32_t cacheMagic = 0x4357444F; // "ODWC"
+    constexpr uint32_t cacheFormatVersion = 2;
+    constexpr size_t cacheDataAlignment = 64;   // alignment of the tensor data in the file
+
+    // Reads values from a memory-mapped file with bounds checking
+    class CacheReader
+    {
+    public:
+      CacheReader(const void* ptr, size_t byteSize)
+        : begin(static_cast<const char*>(ptr)),
+          end(begin + byteSize),
+          cur(begin) {}
+
+      template<typename T>
+      T read()
+      {
+        checkBounds(sizeof(T));
+        T value;
+        memcpy(&value, cur, sizeof(T));
+        cur += sizeof(T);
+        return value;
+      }
+
+      std::string readString(size_t size)
+      {
+        checkBounds(size);
+        std::string str(cur, size);
+        cur += size;
+        return str;
+      }
+
+      // Returns a pointer to a data block at the specified offset from the beginning
+      const char* getData(uint64_t offset, size_t size) const
+      {
+        if (offset > uint64_t(end - begin) || uint64_t(end - begin) - offset < size)
+          throw std::runtime_error("corrupted weights cache file");
+        return begin + offset;
+      }
+
+    private:
+      void checkBounds(size_t size) const
+      {
+        if (size_t(end - cur) < size)
+          throw std::runtime_error("corrupted weights cache file");
+      }
+
+      const char* begin;
+      const char* end;
+      const char* cur;
+    };
+
+    // Writes values to a memory buffer
+    class CacheWriter
+    {
+    public:
+      template<typename T>
+      void write(const T& value)
+      {
+        const char* bytes = reinterpret_cast<const char*>(&value);
+        buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+      }
+
+      void writeString(const std::string& str)
+      {
+        buffer.insert(buffer.end(), str.begin(), str.end());
+      }
+
+      const std::vector<char>& getBuffer() const { return buffer; }
+
+    private:
+      std::vector<char> buffer;
+    };
+  }
+
+  WeightsCache::WeightsCache(Device* device, const std::string& dir, const Data& weightsBlob)
+    : device(device),
+      blob(weightsBlob)
+  {
+    key.version        = OIDN_VERSION;
+    key.blobHash       = hashBytes(weightsBlob.ptr, weightsBlob.size);
+    key.blobByteSize   = weightsBlob.size;
+    key.weightLayout   = static_cast<uint32_t>(device->getWeightLayout());
+    key.weightDataType = static_cast<uint32_t>(device->getWeightDataType());
+    key.tensorBlockC   = static_cast<uint32_t>(device->getTensorBlockC());
+
+    std::stringstream filename;
+    filename << "oidn_weights_" << OIDN_VERSION << "_"
+             << std::hex << std::setfill('0') << std::setw(16) << key.blobHash << std::dec << "_"
+             << device->getWeightLayout() << "_" << device->getWeightDataType() << "_"
+             << key.tensorBlockC << ".bin";
+
+    path = dir;
+    if (!path.empty() && path.back() != '/' && path.back() != '\\')
+      path += '/';
+    path += filename.str();
+  }
+
+  bool WeightsCache::load(Engine* engine, TensorMap& tensorMap)
+  {
+    Ref<MappedFile> file;
+    try
+    {
+      file = makeRef<MappedFile>(path);
+    }
+    catch (const std::exception&)
+    {
+      return false; // the cache file does not exist yet
+    }
+
+    TensorMap cachedTensors;
+
+    try
+    {
+      CacheReader reader(file->getPtr(), file->getByteSize());
+
+      // Parse the header and check whether it matches the key
+      if (reader.read<uint32_t>() != cacheMagic ||
+          reader.read<uint32_t>() != cacheFormatVersion ||
+          reader.read<uint32_t>() != key.version ||
+          reader.read<uint64_t>() != key.blobHash ||
+          reader.read<uint64_t>() != key.blobByteSize ||
+          reader.read<uint32_t>() != key.weightLayout ||
+          reader.read<uint32_t>() != key.weightDataType ||
+          reader.read<uint32_t>() != key.tensorBlockC)
+        throw std::runtime_error("mismatching weights cache file");
+
+      // Check whether the file was created from the same weights blob
+      const uint64_t blobOffset = reader.read<uint64_t>();
+      if (memcmp(reader.getData(blobOffset, blob.size), blob.ptr, blob.size) != 0)
+        throw std::runtime_error("mismatching weights cache file");
+
+      // Parse the tensors
+      const uint32_t numTensors = reader.read<uint32_t>();
+      for (uint32_t i = 0; i < numTensors; ++i)
+      {
+        const std::string name = reader.readString(reader.read<uint16_t>());
+
+        TensorDesc desc;
+        const int rank = reader.read<uint8_t>();
+        desc.dims.resize(rank);
+        desc.paddedDims.resize(rank);
+        for (int j = 0; j < rank; ++j)
+          desc.dims[j] = reader.read<uint32_t>();
+        for (int j = 0; j < rank; ++j)
+          desc.paddedDims[j] = reader.read<uint32_t>();
+        desc.layout   = static_cast<TensorLayout>(reader.read<uint32_t>());
+        desc.dataType = static_cast<DataType>(reader.read<uint32_t>());
+
+        const uint64_t offset = reader.read<uint64_t>();
+        void* data = const_cast<char*>(reader.getData(offset, desc.getByteSize()));
+
+        // The tensor references the mapped file directly, keeping it alive
+        Ref<Tensor> tensor = makeRef<HostTensor>(desc, data, file);
+        if (device->needWeightAndBiasOnDevice())
+          tensor = tensor->toDevice(engine);
+        cachedTensors.emplace(name, tensor);
+      }
+    }
+    catch (const std::exception& e)
+    {
+      device->printWarning("ignoring weights cache file '" + path + "': " + e.what());
+      return false;
+    }
+
+    for (const auto& entry : cachedTensors)
+      tensorMap[entry.first] = entry.second;
+
+    device->printDebug("Loaded weights cache: " + path);
+    return true;
+  }
+
+  void WeightsCache::save(const TensorMap& tensorMap)
+  {
+    // Sort the tensors by name to get a deterministic file
+    const std::map<std::string, Ref<Tensor>> tensors(tensorMap.begin(), tensorMap.end());
+
+    // Compute the size of the header
+    size_t headerByteSize = 7 * sizeof(uint32_t) + 3 * sizeof(uint64_t);
+    for (const auto& entry : tensors)
+    {
+      const Tensor& tensor = *entry.second;
+      headerByteSize += sizeof(uint16_t) + entry.first.size() + sizeof(uint8_t) +
+                        2 * tensor.getRank() * sizeof(uint32_t) +
+                        2 * sizeof(uint32_t) + sizeof(uint64_t);
+    }
+
+    // Write the header
+    CacheWriter writer;
+    writer.write(cacheMagic);
+    writer.write(cacheFormatVersion);
+    writer.write(key.version);
+    writer.write(key.blobHash);
+    writer.write(key.blobByteSize);
+    writer.write(key.weightLayout);
+    writer.write(key.weightDataType);
+    writer.write(key.tensorBlockC);
+
+    // The copy of the weights blob is stored before the tensor data
+    const uint64_t blobOffset = round_up(headerByteSize, cacheDataAlignment);
+    writer.write(blobOffset);
+    writer.write(uint32_t(tensors.size()));
+
+    uint64_t offset = round_up(blobOffset + blob.size, uint64_t(cacheDataAlignment));
+    for (const auto& entry : tensors)
+    {
+      const Tensor& tensor = *entry.second;
+      writer.write(uint16_t(entry.first.size()));
+      writer.writeString(entry.first);
+      writer.write(uint8_t(tensor.getRank()));
+      for (int j = 0; j < tensor.getRank(); ++j)
+        writer.write(uint32_t(tensor.getDesc().dims[j]));
+      for (int j = 0; j < tensor.getRank(); ++j)
+        writer.write(uint32_t(tensor.getDesc().paddedDims[j]));
+      writer.write(static_cast<uint32_t>(tensor.getLayout()));
+      writer.write(static_cast<uint32_t>(tensor.getDataType()));
+      writer.write(offset);
+      offset = round_up(offset + tensor.getByteSize(), uint64_t(cacheDataAlignment));
+    }
+
+    // Write the header followed by the aligned weights blob and tensor data
+    auto writeFunc = [&](std::ostream& file)
+    {
+      const std::vector<char>& header = writer.getBuffer();
+      file.write(header.data(), header.size());
+
+      std::vector<char> hostData;
+      const std::vector<char> padding(cacheDataAlignment, 0);
+      size_t fileByteSize = header.size();
+
+      file.write(padding.data(), blobOffset - fileByteSize);
+      file.write(static_cast<const char*>(blob.ptr), blob.size);
+      fileByteSize = blobOffset + blob.size;
+
+      for (const auto& entry : tensors)
+      {
+        const Tensor& tensor = *entry.second;
+        file.write(padding.data(), round_up(fileByteSize, cacheDataAlignment) - fileByteSize);
+        fileByteSize = round_up(fileByteSize, cacheDataAlignment);
+
+        // Copy the tensor to the host if necessary
+        const char* data = static_cast<const char*>(tensor.getPtr());
+        if (tensor.getBuffer() && tensor.getBuffer()->getStorage() == Storage::Device)
+        {
+          hostData.resize(tensor.getByteSize());
+          tensor.getBuffer()->read(tensor.getByteOffset(), tensor.getByteSize(), hostData.data());
+          data = hostData.data();
+        }
+
+        file.write(data, tensor.getByteSize());
+        fileByteSize += tensor.getByteSize();
+      }
+    };
+
+    if (writeFileAtomic(path, writeFunc))
+      device->printDebug("Saved weights cache: " + path);
+    else
+      device->printWarning("cannot write weights cache file '" + path + "'");
+  }
+
+OIDN_NAMESPACE_END
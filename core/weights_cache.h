@@ -0,0 +1,47 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "tensor.h"
+#include "data.h"
+
+OIDN_NAMESPACE_BEGIN
+
+  class Device;
+
+  // Persistent on-disk cache of the final weights of a model, already converted to the native
+  // weight layout and data type of the device. The cache files are keyed by the hash of the weights
+  // blob and the native weight format, and are memory-mapped when loaded, so the cached weights can
+  // be used by the CPU without any copying. Since different weights blobs may have the same hash,
+  // the cache files contain a copy of the blob as well, which must match when loading them.
+  class WeightsCache
+  {
+  public:
+    WeightsCache(Device* device, const std::string& dir, const Data& weightsBlob);
+
+    // Loads the cached weights into the tensor map, returns false if there is no valid cache file
+    bool load(Engine* engine, TensorMap& tensorMap);
+
+    // Saves the weights in the tensor map to a new cache file (errors are ignored)
+    void save(const TensorMap& tensorMap);
+
+  private:
+    // Key of the cached weights
+    struct Key
+    {
+      uint32_t version;      // library version
+      uint64_t blobHash;     // hash of the weights blob
+      uint64_t blobByteSize; // size of the weights blob
+      uint32_t weightLayout; // native weight layout
+      uint32_t weightDataType;
+      uint32_t tensorBlockC;
+    };
+
+    Device* device;
+    Key key;
+    Data blob; // weights blob
+    std::string path;
+  };
+
+OIDN_NAMESPACE_END
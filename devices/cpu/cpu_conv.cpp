@@ -3,43 +3,78 @@
 
 #include "cpu_conv.h"
 #include "cpu_conv_ispc.h"
+#include "cpu_conv_tuner.h"
 #include "cpu_common.h"
+#include "common/timer.h"
+#include <cstring>
 
 OIDN_NAMESPACE_BEGIN
 
+  namespace
+  {
+    ispc::CPUConvPostOp toISPC(PostOp postOp)
+    {
+      switch (postOp)
+      {
+      case PostOp::None:     return ispc::CPUConvPostOp_None;
+      case PostOp::Pool:     return ispc::CPUConvPostOp_Pool;
+      case PostOp::Upsample: return ispc::CPUConvPostOp_Upsample;
+      default:
+        throw std::invalid_argument("unsupported convolution postop");
+      }
+    }
+  }
+
   CPUConv::CPUConv(CPUEngine* engine, const ConvDesc& desc)
-    : Conv(desc)
+    : Conv(desc),
+      engine(engine)
   {
+    // FP16 tensors are supported as well but all tensors must have the same data type
+    const DataType dataType = srcDesc.dataType;
     if ((srcDesc.layout != TensorLayout::Chw8c &&
-         srcDesc.layout != TensorLayout::Chw16c) || srcDesc.dataType != DataType::Float32)
+         srcDesc.layout != TensorLayout::Chw16c) ||
+        (dataType != DataType::Float32 && dataType != DataType::Float16))
       throw std::invalid_argument("unsupported convolution source layout/data type");
     if (weightDesc.getW() != 3 || weightDesc.getH() != 3)
       throw std::invalid_argument("unsupported convolution kernel size");
     if ((weightDesc.layout != TensorLayout::IOhw8i8o &&
-         weightDesc.layout != TensorLayout::IOhw16i16o) || weightDesc.dataType != DataType::Float32)
+         weightDesc.layout != TensorLayout::IOhw16i16o) || weightDesc.dataType != dataType)
       throw std::invalid_argument("unsupported convolution weight layout/data type");
-    if (biasDesc.layout != TensorLayout::x || biasDesc.dataType != DataType::Float32)
+    if (biasDesc.layout != TensorLayout::x || biasDesc.dataType != dataType)
       throw std::invalid_argument("unsupported convolution bias layout/data type");
 
+    // Pooling is fused by computing multiple output rows at once
+    blockOH = (postOp == PostOp::Pool) ? 2 : 1;
+
+    // Use the largest block of output channel blocks by default
+    const int blockC = getTensorLayoutInfo(dstDesc.layout).blockC;
+    const int OCB = dstDesc.getPaddedC() / blockC;
+    int defaultBlockOCB = min(OCB, ispc::CPUConvKernel_getMaxBlockOCB(toISPC(postOp)));
+    while (OCB % defaultBlockOCB != 0)
+      defaultBlockOCB--;
+
+    setBlocking(defaultBlockOCB, defaultCacheKB, srcDesc.getH());
+  }
+
+  // Sets the blocking parameters for computing the specified number of output rows (before the post-op)
+  void CPUConv::setBlocking(int blockOCB, int cacheKB, int OH)
+  {
     const int blockC = getTensorLayoutInfo(dstDesc.layout).blockC;
     const int IC = srcDesc.getPaddedC();
     const int OC = dstDesc.getPaddedC();
-    const int OH = dstDesc.getH();
-    const int OW = dstDesc.getW();
+    const int OW = srcDesc.getW();
 
     const int OCB = OC / blockC;
-    blockOCB = min(OCB, ispc::CPUConvKernel_getMaxBlockOCB());
-    while (OCB % blockOCB != 0)
-      blockOCB--;
-
+    this->blockOCB = blockOCB;
     OCBB = OCB / blockOCB;
-    blockOW = ispc::CPUConvKernel_getBlockOW(blockOCB);
+    blockOW = ispc::CPUConvKernel_getBlockOW(toISPC(postOp), blockOCB);
 
     // Split the output width into tiles to fit into the L2 cache
-    const size_t cacheSize = 512 * 1024; // FIXME: query actual size but this also works well
+    const size_t cacheSize = size_t(cacheKB) * 1024;
+    const size_t paramByteSize = weightDesc.getByteSize() + biasDesc.getByteSize();
 
     const int tileOW = max(
-      static_cast<int>((cacheSize - weightDesc.getByteSize() - biasDesc.getByteSize()) /
+      static_cast<int>((cacheSize > paramByteSize ? cacheSize - paramByteSize : 0) /
                        (IC * getDataTypeSize(srcDesc.dataType)  * weightDesc.getH() +
                         OC * getDataTypeSize(dstDesc.dataType)) - weightDesc.getW() + 1),
       1);
@@ -47,12 +82,23 @@ OIDN_NAMESPACE_BEGIN
     const int maxOWT = max(OW / (2*blockOW), 1); // max number of OW tiles
     OWT = min(ceil_div(OW, tileOW), maxOWT);     // number of OW tiles
 
-    // Tweak the number of OW tiles to maximize threading efficiency
     const int numThreads = engine->getNumThreads();
+    if (engine->isHybrid())
+    {
+      // On hybrid CPUs, the threads progress at different speeds, so instead of dividing the work
+      // evenly, split it into enough small work items for the faster threads to steal from the
+      // slower ones
+      const size_t minN = size_t(numThreads) * hybridWorkItemsPerThread;
+      while (OWT < maxOWT && size_t(OCBB) * (OH / blockOH) * OWT < minN)
+        ++OWT;
+      return;
+    }
+
+    // Tweak the number of OW tiles to maximize threading efficiency
     double bestThreadEff = 0;
     for (int curOWT = OWT; curOWT < maxOWT; ++curOWT)
     {
-      const size_t N = size_t(OCBB) * OH * curOWT; // work amount
+      const size_t N = size_t(OCBB) * (OH / blockOH) * curOWT; // work amount
       const double threadEff = 1. - double(N % numThreads) / N;
       if (threadEff > bestThreadEff)
       {
@@ -64,36 +110,208 @@ OIDN_NAMESPACE_BEGIN
     }
   }
 
+  // Selects the fastest blocking parameters for the shape of the convolution by benchmarking the
+  // candidates on the first use of the shape, if auto-tuning is enabled
+  void CPUConv::finalize()
+  {
+    CPUConvTuner* tuner = engine->getConvTuner();
+    if (!tuner)
+      return;
+
+    const CPUConvTuner::Key key = {srcDesc.getPaddedC(), dstDesc.getPaddedC(), srcDesc.getW(),
+                                   static_cast<int>(postOp), static_cast<int>(srcDesc.dataType),
+                                   engine->getNumThreads()};
+    // The tuning cache file may contain invalid entries (e.g. corrupted or edited), which have to be
+    // tuned again
+    CPUConvTuner::Params params;
+    if (!tuner->find(key, params) || !isValidBlocking(params))
+    {
+      params = tune();
+      tuner->set(key, params);
+    }
+
+    setBlocking(params.blockOCB, params.cacheKB, srcDesc.getH());
+  }
+
+  bool CPUConv::isValidBlocking(const CPUConvTuner::Params& params) const
+  {
+    const int blockC = getTensorLayoutInfo(dstDesc.layout).blockC;
+    const int OCB = dstDesc.getPaddedC() / blockC;
+    const int maxBlockOCB = min(OCB, ispc::CPUConvKernel_getMaxBlockOCB(toISPC(postOp)));
+    return params.blockOCB >= 1 && params.blockOCB <= maxBlockOCB && OCB % params.blockOCB == 0 &&
+           params.cacheKB > 0;
+  }
+
+  CPUConvTuner::Params CPUConv::tune()
+  {
+    if (!weight || !bias)
+      throw std::logic_error("convolution weight/bias not set");
+
+    // Benchmark on a few rows in temporary tensors, the actual tensors may not be allocated yet
+    const int OH = min(srcDesc.getH(), round_up(benchmarkOH, blockOH)); // before the post-op
+    TensorDesc benchSrcDesc = srcDesc;
+    TensorDesc benchDstDesc = dstDesc;
+    benchSrcDesc.dims[1] = benchSrcDesc.paddedDims[1] = OH;
+    benchDstDesc.dims[1] = benchDstDesc.paddedDims[1] =
+      (postOp == PostOp::Pool) ? OH / 2 : ((postOp == PostOp::Upsample) ? OH * 2 : OH);
+
+    auto benchSrc = engine->newTensor(benchSrcDesc, Storage::Host);
+    auto benchDst = engine->newTensor(benchDstDesc, Storage::Host);
+    memset(benchSrc->getPtr(), 0, benchSrc->getByteSize());
+    const ispc::TensorAccessor3D srcAcc = *benchSrc;
+    const ispc::TensorAccessor3D dstAcc = *benchDst;
+
+    // Candidates: all valid blocks of output channel blocks and a range of cache budgets
+    const int blockC = getTensorLayoutInfo(dstDesc.layout).blockC;
+    const int OCB = dstDesc.getPaddedC() / blockC;
+    const int maxBlockOCB = min(OCB, ispc::CPUConvKernel_getMaxBlockOCB(toISPC(postOp)));
+    const int candidateCacheKBs[] = {128, 256, 512, 1024, 2048};
+
+    CPUConvTuner::Params bestParams = {blockOCB, defaultCacheKB};
+    double bestTime = INFINITY;
+
+    for (int curBlockOCB = 1; curBlockOCB <= maxBlockOCB; ++curBlockOCB)
+    {
+      if (OCB % curBlockOCB != 0)
+        continue;
+
+      for (int cacheKB : candidateCacheKBs)
+      {
+        setBlocking(curBlockOCB, cacheKB, OH);
+
+        // Take the fastest of a few runs after a warm-up run
+        run(srcAcc, dstAcc, 0, OH);
+        double time = INFINITY;
+        for (int i = 0; i < benchmarkRuns; ++i)
+        {
+          Timer timer;
+          run(srcAcc, dstAcc, 0, OH);
+          time = min(time, timer.query());
+        }
+
+        if (time < bestTime)
+        {
+          bestParams = {curBlockOCB, cacheKB};
+          bestTime = time;
+        }
+      }
+    }
+
+    if (engine->getDevice()->isVerbose(3))
+    {
+      std::cout << "Tuned convolution " << getName() << ": blockOCB=" << bestParams.blockOCB
+                << " cacheKB=" << bestParams.cacheKB << std::endl;
+    }
+
+    return bestParams;
+  }
+
   void CPUConv::submit()
   {
     if (!src || !dst)
       throw std::logic_error("conving source/destination not set");
 
-    const int OH = dstDesc.getH();
-    const int OW = dstDesc.getW();
+    const ispc::TensorAccessor3D srcAcc = *src;
+    const ispc::TensorAccessor3D dstAcc = *dst;
+    const int OH = srcDesc.getH(); // before the post-op
+
+    engine->submitHostFunc([=]() { run(srcAcc, dstAcc, 0, OH); });
+  }
+
+  void CPUConv::getSrcRows(int rowBegin, int rowEnd, int& srcRowBegin, int& srcRowEnd) const
+  {
+    // Convert to the rows before the post-op, and extend them with the padding of the kernel
+    int ohBegin, ohEnd;
+    switch (postOp)
+    {
+    case PostOp::Pool:
+      ohBegin = rowBegin * 2;
+      ohEnd   = rowEnd   * 2;
+      break;
+    case PostOp::Upsample:
+      ohBegin = rowBegin / 2;
+      ohEnd   = ceil_div(rowEnd, 2);
+      break;
+    default:
+      ohBegin = rowBegin;
+      ohEnd   = rowEnd;
+    }
+
+    srcRowBegin = ohBegin - 1; // PH = 1 (KH = 3)
+    srcRowEnd   = ohEnd   + 1;
+  }
+
+  std::function<void(int, int)> CPUConv::getRowFunc()
+  {
+    if (!src || !dst)
+      throw std::logic_error("conving source/destination not set");
+
+    const ispc::TensorAccessor3D srcAcc = *src;
+    const ispc::TensorAccessor3D dstAcc = *dst;
+    const int OH = srcDesc.getH();
+
+    return [=](int rowBegin, int rowEnd)
+    {
+      switch (postOp)
+      {
+      case PostOp::Pool:
+        run(srcAcc, dstAcc, rowBegin * 2, rowEnd * 2);
+        break;
+      case PostOp::Upsample:
+        run(srcAcc, dstAcc, rowBegin / 2, min(ceil_div(rowEnd, 2), OH));
+        break;
+      default:
+        run(srcAcc, dstAcc, rowBegin, rowEnd);
+      }
+    };
+  }
+
+  void CPUConv::run(const ispc::TensorAccessor3D& srcAcc, const ispc::TensorAccessor3D& dstAcc,
+                    int ohBegin, int ohEnd) const
+  {
+    if (ohBegin % blockOH != 0 || ohEnd % blockOH != 0)
+      throw std::logic_error("convolution rows are not aligned");
+
+    const int OW = srcDesc.getW();
+    const int OHB = (ohEnd - ohBegin) / blockOH;
 
     ispc::CPUConvKernel kernel;
-    kernel.src    = *src;
+    kernel.src    = srcAcc;
     kernel.weight = *weight;
     kernel.bias   = *bias;
-    kernel.dst    = *dst;
+    kernel.dst    = dstAcc;
     kernel.relu   = activation == Activation::ReLU;
+    kernel.postOp = toISPC(postOp);
 
-    const size_t N = size_t(OCBB) * OH * OWT;
-    parallel_nd(N, [&](size_t i)
+    const size_t N = size_t(OCBB) * OHB * OWT;
+    auto computeItem = [&](size_t i)
     {
       const size_t j = i / OCBB;
       const int ocbb = int(i % OCBB);
-      const int oh   = int(j % OH);
-      const int owt  = int(j / OH);
+      const int oh   = ohBegin + int(j % OHB) * blockOH;
+      const int owt  = int(j / OHB);
 
-      constexpr int PW = 1; // KW = 3
-      const int owr = OWT * (blockOW - PW - 1);
-      const int owBegin = owt   > 0   ? (owt     * OW + owr) / (OWT*blockOW) * blockOW + PW : 0;
-      const int owEnd   = owt+1 < OWT ? ((owt+1) * OW + owr) / (OWT*blockOW) * blockOW + PW : OW;
+      // The width blocks start after the first (padded) block, which has 2 columns with pooling
+      const int owOffset = (postOp == PostOp::Pool) ? 2 : 1; // PW = 1 (KW = 3)
+      const int owr = OWT * (blockOW - owOffset - 1);
+      const int owBegin = owt   > 0   ? (owt     * OW + owr) / (OWT*blockOW) * blockOW + owOffset : 0;
+      const int owEnd   = owt+1 < OWT ? ((owt+1) * OW + owr) / (OWT*blockOW) * blockOW + owOffset : OW;
 
       ispc::CPUConvKernel_run(&kernel, blockOCB, ocbb * blockOCB, oh, owBegin, owEnd);
-    });
+    };
+
+    if (engine->isHybrid())
+    {
+      // Schedule each work item as a separate task, so none of them gets stuck in a large chunk on
+      // a slow core at the end of the operation
+      tbb::parallel_for(tbb::blocked_range<size_t>(0, N, 1), [&](const tbb::blocked_range<size_t>& r)
+      {
+        for (size_t i = r.begin(); i != r.end(); ++i)
+          computeItem(i);
+      }, tbb::simple_partitioner());
+    }
+    else
+      parallel_nd(N, computeItem);
   }
 
 OIDN_NAMESPACE_END
\ No newline at end of file
@@ -5,18 +5,47 @@
 
 #include "core/conv.h"
 #include "cpu_engine.h"
+#include "cpu_row_op.h"
+#include "cpu_conv_tuner.h"
 
 OIDN_NAMESPACE_BEGIN
 
-  class CPUConv final : public Conv
+  class CPUConv final : public Conv, public CPURowOp
   {
   public:
     CPUConv(CPUEngine* engine, const ConvDesc& desc);
+    void finalize() override;
     void submit() override;
 
+    int getNumRows() const override { return dstDesc.getH(); }
+    int getRowAlignment() const override { return postOp == PostOp::Upsample ? 2 : 1; }
+    void getSrcRows(int rowBegin, int rowEnd, int& srcRowBegin, int& srcRowEnd) const override;
+    std::function<void(int, int)> getRowFunc() override;
+
+    // Computes only the output rows [ohBegin, ohEnd) (before the post-op, aligned to the row block)
+    // using the specified source and destination accessors, which may be views of row bands
+    // Must be called from a host function.
+    void run(const ispc::TensorAccessor3D& srcAcc, const ispc::TensorAccessor3D& dstAcc,
+             int ohBegin, int ohEnd) const;
+
+    int getBlockOH() const { return blockOH; }
+
+    // Per-thread cache budget for blocking the convolution if it is not tuned
+    static constexpr int defaultCacheKB = 512; // FIXME: query actual size but this also works well
+
   private:
+    void setBlocking(int blockOCB, int cacheKB, int OH);
+    bool isValidBlocking(const CPUConvTuner::Params& params) const;
+    CPUConvTuner::Params tune();
+
+    static constexpr int benchmarkOH = 16;     // number of output rows to run when tuning
+    static constexpr int benchmarkRuns = 3;    // number of timed runs per candidate when tuning
+    static constexpr int hybridWorkItemsPerThread = 8; // min number of work items per thread on hybrid CPUs
+
+    CPUEngine* engine;
     int blockOCB; // block of output channel blocks
-    int blockOW;  // block of output width
+    int blockOH;  // block of output height (before the post-op)
+    int blockOW;  // block of output width (before the post-op)
     int OCBB;     // number of output channel block blocks
     int OWT;      // number of output width tiles
   };
@@ -0,0 +1,160 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "cpu_conv_chain.h"
+#include "cpu_common.h"
+#include "cpu_conv_ispc.h"
+#include <cstring>
+
+OIDN_NAMESPACE_BEGIN
+
+  CPUConvChain::CPUConvChain(CPUEngine* engine, const std::vector<ConvDesc>& convDescs)
+    : ConvChain(convDescs),
+      engine(engine)
+  {
+    for (const auto& desc : convDescs)
+      convs.push_back(makeRef<CPUConv>(engine, desc));
+
+    const TensorDesc& srcDesc = convDescs.front().srcDesc;
+    const int numConvs = getNumConvs();
+    const int H = srcDesc.getH();
+    const int W = srcDesc.getW();
+    const size_t dataTypeSize = getDataTypeSize(srcDesc.dataType);
+
+    // Size of a row of all intermediate outputs
+    size_t rowByteSize = 0;
+    for (int i = 0; i < numConvs - 1; ++i)
+      rowByteSize += size_t(convDescs[i].weightDesc.getPaddedO()) * W * dataTypeSize;
+
+    // Choose the band height such that the sliding windows fit into the combined per-thread cache
+    // budgets of the convolutions, but have enough rows to keep all threads busy
+    const size_t cacheSize = size_t(engine->getNumThreads()) * CPUConv::defaultCacheKB * 1024;
+    const int minBandH = 8;
+    bandH = max(int(cacheSize / rowByteSize) - numConvs, minBandH);
+    bandH = min(round_up(bandH, 2), round_up(H, 2)); // multiple of the row block of the last convolution
+
+    // The first band needs the most rows: the intermediate output before the last convolution
+    // extends by one row beyond the band for each convolution after it
+    windowH = min(bandH + numConvs, H);
+
+    scratchByteSize = 0;
+    for (int i = 0; i < numConvs - 1; ++i)
+    {
+      windowByteOffsets.push_back(scratchByteSize);
+      scratchByteSize += round_up(size_t(convDescs[i].weightDesc.getPaddedO()) * windowH * W * dataTypeSize,
+                                  memoryAlignment);
+    }
+  }
+
+  void CPUConvChain::setScratch(const Ref<Buffer>& scratch)
+  {
+    if (scratch && scratch->getByteSize() < scratchByteSize)
+      throw std::invalid_argument("convolution chain scratch buffer too small");
+    this->scratch = scratch;
+  }
+
+  void CPUConvChain::finalize()
+  {
+    for (auto& conv : convs)
+      conv->finalize();
+  }
+
+  void CPUConvChain::submit()
+  {
+    if (!src || !dst)
+      throw std::logic_error("convolution chain source/destination not set");
+    if (!scratch)
+      throw std::logic_error("convolution chain scratch not set");
+    for (int i = 0; i < getNumConvs(); ++i)
+    {
+      if (!weights[i] || !biases[i])
+        throw std::logic_error("convolution chain weight/bias not set");
+    }
+
+    const ispc::TensorAccessor3D srcAcc = *src;
+    const ispc::TensorAccessor3D dstAcc = *dst;
+    char* scratchPtr = static_cast<char*>(scratch->getPtr());
+
+    engine->submitHostFunc([=]() { runBands(srcAcc, dstAcc, scratchPtr); });
+  }
+
+  void CPUConvChain::runBands(const ispc::TensorAccessor3D& srcAcc, const ispc::TensorAccessor3D& dstAcc,
+                              char* scratchPtr) const
+  {
+    const int numConvs = getNumConvs();
+    const int H = srcAcc.H;
+
+    // The sliding windows are accessed with the row indices of the full intermediate outputs, by
+    // offsetting their pointers by the first row stored in the window
+    std::vector<ispc::TensorAccessor3D> windowAccs(numConvs - 1);
+    std::vector<int> windowBegins(numConvs - 1, 0); // first row stored in the window
+    std::vector<int> rowEnds(numConvs - 1, 0);      // end of the rows computed so far
+
+    for (int i = 0; i < numConvs - 1; ++i)
+    {
+      const TensorDesc& windowDesc = convDescs[i+1].srcDesc;
+      ispc::TensorAccessor3D& acc = windowAccs[i];
+      acc.ptr = reinterpret_cast<uint8_t*>(scratchPtr + windowByteOffsets[i]);
+      acc.dataType = toISPC(windowDesc.dataType);
+      acc.C = windowDesc.getPaddedC();
+      acc.H = H;
+      acc.W = windowDesc.getW();
+      acc.hByteStride = size_t(acc.W) * getTensorLayoutInfo(windowDesc.layout).blockC *
+                        getDataTypeSize(windowDesc.dataType);
+      acc.CByteStride = size_t(windowH) * acc.hByteStride;
+    }
+
+    for (int bandBegin = 0; bandBegin < H; bandBegin += bandH)
+    {
+      const int bandEnd = min(bandBegin + bandH, H);
+
+      for (int i = 0; i < numConvs; ++i)
+      {
+        const bool isLast = (i == numConvs - 1);
+
+        // Each convolution computes the rows needed by the next one in the current band, which
+        // extend by one row for each subsequent convolution
+        const int rowBegin = isLast ? bandBegin : rowEnds[i];
+        const int rowEnd   = isLast ? bandEnd : min(bandEnd + (numConvs - 1 - i), H);
+
+        ispc::TensorAccessor3D convDstAcc = dstAcc;
+        if (!isLast)
+        {
+          // Slide the window: keep only the already computed rows needed by the next convolution
+          const int nextRowBegin = (i + 1 == numConvs - 1) ? bandBegin : rowEnds[i+1];
+          const int windowBegin = max(nextRowBegin - 1, 0);
+          ispc::TensorAccessor3D& acc = windowAccs[i];
+
+          if (windowBegin > windowBegins[i])
+          {
+            const size_t keepByteSize = size_t(rowEnds[i] - windowBegin) * acc.hByteStride;
+            const size_t shiftByteSize = size_t(windowBegin - windowBegins[i]) * acc.hByteStride;
+            uint8_t* basePtr = acc.ptr + size_t(windowBegins[i]) * acc.hByteStride; // first stored row
+
+            for (int cb = 0; cb < acc.C / getTensorLayoutInfo(convDescs[i+1].srcDesc.layout).blockC; ++cb)
+            {
+              uint8_t* blockPtr = basePtr + cb * acc.CByteStride;
+              std::memmove(blockPtr, blockPtr + shiftByteSize, keepByteSize);
+            }
+
+            acc.ptr = basePtr - size_t(windowBegin) * acc.hByteStride;
+            windowBegins[i] = windowBegin;
+          }
+
+          if (rowEnd - windowBegins[i] > windowH)
+            throw std::logic_error("convolution chain window too small");
+
+          convDstAcc = acc;
+        }
+
+        const ispc::TensorAccessor3D& convSrcAcc = (i == 0) ? srcAcc : windowAccs[i-1];
+        if (rowBegin < rowEnd)
+          convs[i]->run(convSrcAcc, convDstAcc, rowBegin, rowEnd);
+
+        if (!isLast)
+          rowEnds[i] = rowEnd;
+      }
+    }
+  }
+
+OIDN_NAMESPACE_END
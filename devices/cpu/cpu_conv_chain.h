@@ -0,0 +1,40 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "core/conv_chain.h"
+#include "cpu_conv.h"
+
+OIDN_NAMESPACE_BEGIN
+
+  // Chain of convolutions executed in row bands (depth-first), keeping only small sliding windows of
+  // the intermediate outputs in scratch memory, which mostly fit into the caches
+  class CPUConvChain final : public ConvChain
+  {
+  public:
+    CPUConvChain(CPUEngine* engine, const std::vector<ConvDesc>& convDescs);
+
+    size_t getScratchByteSize() const override { return scratchByteSize; }
+    void setScratch(const Ref<Buffer>& scratch) override;
+
+    void finalize() override;
+    void submit() override;
+
+  private:
+    void updateWeight(int convIndex) override { convs[convIndex]->setWeight(weights[convIndex]); }
+    void updateBias(int convIndex) override { convs[convIndex]->setBias(biases[convIndex]); }
+
+    void runBands(const ispc::TensorAccessor3D& srcAcc, const ispc::TensorAccessor3D& dstAcc,
+                  char* scratchPtr) const;
+
+    CPUEngine* engine;
+    std::vector<Ref<CPUConv>> convs;
+    int bandH;   // number of output rows of the last convolution (before the post-op) per band
+    int windowH; // number of rows in the sliding windows of the intermediate outputs
+    std::vector<size_t> windowByteOffsets; // offsets of the sliding windows in the scratch
+    size_t scratchByteSize;
+    Ref<Buffer> scratch;
+  };
+
+OIDN_NAMESPACE_END
@@ -0,0 +1,97 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "cpu_conv_tuner.h"
+#include "core/hash.h"
+#include "core/atomic_file.h"
+#include <fstream>
+#include <iomanip>
+
+OIDN_NAMESPACE_BEGIN
+
+  CPUConvTuner::CPUConvTuner(CPUDevice* device, const std::string& dir)
+    : device(device)
+  {
+    if (dir.empty())
+      return;
+
+    // The tuned parameters depend on the CPU model and the instruction set used by the kernels
+    const std::string cpuName = CPUDevice::getName();
+    std::stringstream filename;
+    filename << "oidn_cpu_tuning_" << OIDN_VERSION << "_"
+             << std::hex << std::setfill('0') << std::setw(16) << hashBytes(cpuName.data(), cpuName.size())
+             << std::dec << "_" << static_cast<int>(CPUDevice::getArch()) << ".txt";
+
+    path = dir;
+    if (path.back() != '/' && path.back() != '\\')
+      path += '/';
+    path += filename.str();
+
+    load(entries);
+    if (!entries.empty())
+      device->printDebug("Loaded convolution tuning cache: " + path);
+  }
+
+  bool CPUConvTuner::find(const Key& key, Params& params)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(key);
+    if (it == entries.end())
+      return false;
+    params = it->second;
+    return true;
+  }
+
+  void CPUConvTuner::set(const Key& key, const Params& params)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries[key] = params;
+    dirty = true;
+  }
+
+  // Loads the entries from the tuning cache file, ignoring malformed lines
+  void CPUConvTuner::load(std::map<Key, Params>& dstEntries) const
+  {
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line))
+    {
+      std::istringstream stream(line);
+      Key key;
+      Params params;
+      if (stream >> key.IC >> key.OC >> key.OW >> key.postOp >> key.dataType >> key.numThreads
+                 >> params.blockOCB >> params.cacheKB)
+        dstEntries.emplace(key, params);
+    }
+  }
+
+  void CPUConvTuner::save()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!dirty || path.empty())
+      return;
+
+    // Merge the entries saved by other processes in the meantime
+    std::map<Key, Params> fileEntries;
+    load(fileEntries);
+    for (const auto& entry : fileEntries)
+      entries.emplace(entry.first, entry.second);
+
+    auto writeFunc = [&](std::ostream& file)
+    {
+      for (const auto& entry : entries)
+      {
+        const Key& key = entry.first;
+        const Params& params = entry.second;
+        file << key.IC << " " << key.OC << " " << key.OW << " " << key.postOp << " "
+             << key.dataType << " " << key.numThreads << " "
+             << params.blockOCB << " " << params.cacheKB << std::endl;
+      }
+    };
+
+    if (!writeFileAtomic(path, writeFunc))
+      device->printWarning("cannot write convolution tuning cache file '" + path + "'");
+    dirty = false;
+  }
+
+OIDN_NAMESPACE_END
@@ -0,0 +1,64 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "cpu_device.h"
+#include <map>
+#include <tuple>
+#include <mutex>
+
+OIDN_NAMESPACE_BEGIN
+
+  // Stores the blocking parameters of the convolutions selected by benchmarking, keyed by the shape
+  // of the convolutions. The results are kept in memory and optionally in a file shared by all
+  // processes running on the same CPU model, thus the benchmarks have to run only on first use.
+  class CPUConvTuner
+  {
+  public:
+    // Shape of a convolution
+    struct Key
+    {
+      int IC, OC; // padded number of input/output channels
+      int OW;     // output width (before the post-op)
+      int postOp;
+      int dataType;
+      int numThreads;
+
+      bool operator <(const Key& other) const
+      {
+        return std::tie(IC, OC, OW, postOp, dataType, numThreads) <
+               std::tie(other.IC, other.OC, other.OW, other.postOp, other.dataType, other.numThreads);
+      }
+    };
+
+    // Blocking parameters
+    struct Params
+    {
+      int blockOCB; // block of output channel blocks
+      int cacheKB;  // cache budget for splitting the output width into tiles
+    };
+
+    // The tuning cache file is stored in the specified directory, disabled if empty
+    CPUConvTuner(CPUDevice* device, const std::string& dir);
+
+    // Gets the tuned parameters for a shape, returns false if the shape has not been tuned yet
+    bool find(const Key& key, Params& params);
+
+    // Stores the tuned parameters for a shape, which are saved to the tuning cache file only by save
+    void set(const Key& key, const Params& params);
+
+    // Saves the parameters tuned since the last save to the tuning cache file
+    void save();
+
+  private:
+    void load(std::map<Key, Params>& dstEntries) const;
+
+    CPUDevice* device;
+    std::string path;
+    std::map<Key, Params> entries;
+    bool dirty = false; // there are unsaved entries
+    std::mutex mutex;
+  };
+
+OIDN_NAMESPACE_END
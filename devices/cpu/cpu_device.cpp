@@ -80,26 +80,44 @@ OIDN_NAMESPACE_BEGIN
   {
     switch (ispc::getCPUArch())
     {
-    case ispc::CPUArch_SSE4:   return CPUArch::SSE41;
-    case ispc::CPUArch_AVX2:   return CPUArch::AVX2;
-    case ispc::CPUArch_AVX512: return CPUArch::AVX512;
-    case ispc::CPUArch_NEON:   return CPUArch::NEON;
-    default:                   return CPUArch::Unknown;
+    case ispc::CPUArch_SSE4:      return CPUArch::SSE41;
+    case ispc::CPUArch_AVX2:      return CPUArch::AVX2;
+    case ispc::CPUArch_AVX512:    return CPUArch::AVX512;
+    case ispc::CPUArch_AVX512SPR: return CPUArch::AVX512SPR;
+    case ispc::CPUArch_NEON:      return CPUArch::NEON;
+    default:                      return CPUArch::Unknown;
     }
   }
 
-  CPUDevice::CPUDevice()
+  CPUDevice::CPUDevice(ParallelForFunction parallelForFunc, void* parallelForUserPtr)
   {
     systemMemorySupported  = true;
     managedMemorySupported = true;
 
+    if (parallelForFunc)
+      parallelFor.reset(new ParallelFor(parallelForFunc, parallelForUserPtr));
+
     // Get default values from environment variables
     getEnvVar("OIDN_NUM_THREADS", numThreads);
     getEnvVar("OIDN_SET_AFFINITY", setAffinity);
+    getEnvVar("OIDN_NUMA", numa);
+    getEnvVar("OIDN_PERFORMANCE_CORES_ONLY", performanceCoresOnly);
+    getEnvVar("OIDN_MAX_CONCURRENT_TILES", maxConcurrentTiles);
+    getEnvVar("OIDN_REDUCED_PRECISION", reducedPrecision);
+    getEnvVar("OIDN_AUTOTUNE", autotune);
   }
 
   CPUDevice::~CPUDevice()
   {
+    // Wait for the pending work of the engines, and destroy them before the thread arena used
+    // by their queues
+    try
+    {
+      wait();
+    }
+    catch (...) {}
+
+    subdevices.clear();
     observer.reset();
   }
 
@@ -114,25 +132,43 @@ OIDN_NAMESPACE_BEGIN
       std::cout << "    ISA     : ";
       switch (arch)
       {
-      case CPUArch::SSE2:   std::cout << "SSE2";    break;
-      case CPUArch::SSE41:  std::cout << "SSE4.1";  break;
-      case CPUArch::AVX2:   std::cout << "AVX2";    break;
-      case CPUArch::AVX512: std::cout << "AVX-512"; break;
-      case CPUArch::NEON:   std::cout << "NEON";    break;
-      default:              std::cout << "Unknown"; break;
+      case CPUArch::SSE2:      std::cout << "SSE2";        break;
+      case CPUArch::SSE41:     std::cout << "SSE4.1";      break;
+      case CPUArch::AVX2:      std::cout << "AVX2";        break;
+      case CPUArch::AVX512:    std::cout << "AVX-512";     break;
+      case CPUArch::AVX512SPR: std::cout << "AVX-512 SPR"; break;
+      case CPUArch::NEON:      std::cout << "NEON";        break;
+      default:                 std::cout << "Unknown";     break;
       }
       std::cout << std::endl;
     }
 
     initTasking();
 
-    tensorDataType = DataType::Float32;
-    weightDataType = DataType::Float32;
+    // Store the activations and weights in FP16 if requested and the engine can compute in
+    // reduced precision efficiently, otherwise fall back to FP32
+    DataType dataType = DataType::Float32;
+    if (reducedPrecision)
+    {
+    #if defined(OIDN_DNNL)
+      const bool reducedPrecisionSupported = arch == CPUArch::AVX512SPR; // native FP16/AMX
+    #elif defined(OIDN_BNNS)
+      const bool reducedPrecisionSupported = false;
+    #else
+      const bool reducedPrecisionSupported = arch != CPUArch::SSE2 && arch != CPUArch::SSE41;
+    #endif
+
+      if (reducedPrecisionSupported)
+        dataType = DataType::Float16;
+      else
+        printWarning("reduced precision is not supported by the CPU, using full precision");
+    }
 
-    std::unique_ptr<Engine> engine;
+    tensorDataType = dataType;
+    weightDataType = dataType;
 
   #if defined(OIDN_DNNL)
-    if (arch == CPUArch::AVX512)
+    if (arch == CPUArch::AVX512 || arch == CPUArch::AVX512SPR)
     {
       tensorLayout = TensorLayout::Chw16c;
       weightLayout = TensorLayout::OIhw16i16o;
@@ -144,16 +180,12 @@ OIDN_NAMESPACE_BEGIN
       weightLayout = TensorLayout::OIhw8i8o;
       tensorBlockC = 8;
     }
-
-    engine.reset(new DNNLEngine(this));
   #elif defined(OIDN_BNNS)
     tensorLayout = TensorLayout::chw;
     weightLayout = TensorLayout::oihw;
     tensorBlockC = 1;
-
-    engine.reset(new BNNSEngine(this));
   #else
-    if (arch == CPUArch::AVX512)
+    if (arch == CPUArch::AVX512 || arch == CPUArch::AVX512SPR)
     {
       tensorLayout = TensorLayout::Chw16c;
       weightLayout = TensorLayout::IOhw16i16o;
@@ -165,22 +197,41 @@ OIDN_NAMESPACE_BEGIN
       weightLayout = TensorLayout::IOhw8i8o;
       tensorBlockC = 8;
     }
-
-    engine.reset(new CPUEngine(this));
   #endif
 
-    subdevices.emplace_back(new Subdevice(std::move(engine)));
+    // Create a subdevice for each thread arena
+    for (int i = 0; i < int(threadArenas.size()); ++i)
+    {
+      std::unique_ptr<Engine> engine;
+    #if defined(OIDN_DNNL)
+      engine.reset(new DNNLEngine(this, i));
+    #elif defined(OIDN_BNNS)
+      engine.reset(new BNNSEngine(this));
+    #else
+      engine.reset(new CPUEngine(this, i));
+    #endif
+      subdevices.emplace_back(new Subdevice(std::move(engine)));
+    }
   }
 
   void CPUDevice::initTasking()
   {
+    if (parallelFor)
+    {
+      initExternalTasking();
+      return;
+    }
+
+    // Detect hybrid CPUs with multiple core types (e.g. performance and efficient cores)
+    bool hybrid = false;
+  #if TBB_INTERFACE_VERSION >= 12020 // oneTBB 2021.2 or later
+    const std::vector<tbb::core_type_id> coreTypes = tbb::info::core_types();
+    hybrid = coreTypes.size() > 1;
+  #endif
+
     // Get the thread affinities for one thread per core on non-hybrid CPUs with SMT
   #if !(defined(__APPLE__) && defined(OIDN_ARCH_ARM64))
-    if (setAffinity
-      #if TBB_INTERFACE_VERSION >= 12020 // oneTBB 2021.2 or later
-        && tbb::info::core_types().size() <= 1 // non-hybrid cores
-      #endif
-       )
+    if (setAffinity && !hybrid)
     {
       affinity = std::make_shared<ThreadAffinity>(1, verbose);
       if (affinity->getNumThreads() == 0 ||                                           // detection failed
@@ -190,14 +241,73 @@ OIDN_NAMESPACE_BEGIN
     }
   #endif
 
-    // Create the task arena
-    const int maxNumThreads = affinity ? affinity->getNumThreads() : tbb::this_task_arena::max_concurrency();
-    numThreads = (numThreads > 0) ? min(numThreads, maxNumThreads) : maxNumThreads;
-    arena = std::make_shared<tbb::task_arena>(numThreads);
+  #if TBB_INTERFACE_VERSION >= 12020
+    // On hybrid CPUs, optionally use only the most performant core type, so operations do not have
+    // to wait for the slower cores (TBB lists the core types in ascending order of performance)
+    tbb::core_type_id coreType = -1;
+    if (performanceCoresOnly)
+    {
+      if (hybrid)
+        coreType = coreTypes.back();
+      else
+        printDebug("The CPU does not have multiple core types, using all cores");
+    }
+
+    // In NUMA-aware mode, create a task arena bound to each NUMA node, which requires TBB to be
+    // able to detect the NUMA topology
+    std::vector<tbb::numa_node_id> numaNodes;
+    if (numa)
+    {
+      numaNodes = tbb::info::numa_nodes();
+      if (numaNodes.size() <= 1)
+      {
+        numaNodes.clear();
+        printDebug("Only a single NUMA node was detected, NUMA-aware mode is disabled");
+      }
+    }
+
+    if (!numaNodes.empty() || coreType >= 0)
+    {
+      if (numaNodes.empty())
+        numaNodes.push_back(-1); // a single arena not bound to a NUMA node
+      initConstrainedArenas(numaNodes, coreType);
+    }
+  #else
+    if (numa)
+      printWarning("NUMA-aware mode is not supported by the TBB version");
+    if (performanceCoresOnly)
+      printWarning("using only the performance cores is not supported by the TBB version");
+  #endif
+
+    // Otherwise create a single task arena
+    if (threadArenas.empty())
+    {
+      const int maxNumThreads = affinity ? affinity->getNumThreads() : tbb::this_task_arena::max_concurrency();
+      numThreads = (numThreads > 0) ? min(numThreads, maxNumThreads) : maxNumThreads;
+
+      ThreadArena threadArena;
+      threadArena.arena = std::make_shared<tbb::task_arena>(numThreads);
+      threadArena.numThreads = numThreads;
+      threadArena.numaNodeID = -1;
+      threadArena.hybrid = hybrid;
+      threadArenas.push_back(threadArena);
+
+      // Automatically set the thread affinities
+      if (affinity)
+        observer = std::make_shared<PinningObserver>(affinity, *threadArenas[0].arena);
+    }
+
+    // Determine the maximum number of tiles which can be processed concurrently in nested arenas
+    // of a subdevice, keeping enough threads per tile to parallelize the individual operations
+    // efficiently
+    int minArenaThreads = numThreads;
+    for (const auto& threadArena : threadArenas)
+      minArenaThreads = min(minArenaThreads, threadArena.numThreads);
 
-    // Automatically set the thread affinities
-    if (affinity)
-      observer = std::make_shared<PinningObserver>(affinity, *arena);
+    if (maxConcurrentTiles > 0)
+      maxConcurrentTiles = min(maxConcurrentTiles, minArenaThreads);
+    else
+      maxConcurrentTiles = max(minArenaThreads / minTileThreads, 1);
 
     if (isVerbose())
     {
@@ -210,8 +320,89 @@ OIDN_NAMESPACE_BEGIN
     #endif
       std::cout << std::endl;
       std::cout << "    Threads : " << numThreads << " (" << (affinity ? "affinitized" : "non-affinitized") << ")" << std::endl;
+      if (hybrid)
+      {
+        std::cout << "    Cores   : " << (threadArenas[0].hybrid ? "all" : "performance only")
+                  << " (hybrid)" << std::endl;
+      }
+      if (threadArenas[0].numaNodeID >= 0)
+      {
+        std::cout << "    NUMA    : " << threadArenas.size() << " nodes (";
+        for (size_t i = 0; i < threadArenas.size(); ++i)
+          std::cout << (i > 0 ? ", " : "") << threadArenas[i].numThreads;
+        std::cout << " threads)" << std::endl;
+      }
+      std::cout << "    Tiles   : " << maxConcurrentTiles << " concurrent (max)" << std::endl;
+    }
+  }
+
+  void CPUDevice::initExternalTasking()
+  {
+  #if defined(OIDN_DNNL) || defined(OIDN_BNNS)
+    throw Exception(Error::InvalidOperation,
+                    "the CPU device does not support a parallel for function with the current build configuration");
+  #endif
+
+    if (numa)
+      printWarning("NUMA-aware mode is not supported with a parallel for function");
+    if (performanceCoresOnly)
+      printWarning("using only the performance cores is not supported with a parallel for function");
+
+    // The parallel work is executed by the threads of the application, thus the arena of the
+    // device has only a single thread, which executes the work which cannot be dispatched to the
+    // parallel for function (e.g. small reductions) serially. The number of threads is used only
+    // for partitioning the work.
+    if (numThreads <= 0)
+      numThreads = tbb::this_task_arena::max_concurrency();
+
+    ThreadArena threadArena;
+    threadArena.arena = std::make_shared<tbb::task_arena>(1);
+    threadArena.numThreads = numThreads;
+    threadArena.numaNodeID = -1;
+    threadArena.hybrid = false;
+    threadArenas.push_back(threadArena);
+
+    // Tiles and operations cannot be processed concurrently without nested parallelism
+    maxConcurrentTiles = 1;
+
+    if (isVerbose())
+    {
+      std::cout << "  Tasking   : external parallel for function" << std::endl;
+      std::cout << "    Threads : " << numThreads << std::endl;
+    }
+  }
+
+#if TBB_INTERFACE_VERSION >= 12020
+  void CPUDevice::initConstrainedArenas(const std::vector<tbb::numa_node_id>& numaNodes,
+                                        tbb::core_type_id coreType)
+  {
+    // TBB binds the threads of each arena to the cores of its NUMA node and/or core type, so the
+    // pinning observer is not used, but the threads are still limited to one per core if
+    // affinitization is enabled
+    const bool oneThreadPerCore = affinity || (setAffinity && coreType >= 0);
+    const int numArenas = int(numaNodes.size());
+    const int maxArenaThreads = (numThreads > 0) ? max(ceil_div(numThreads, numArenas), 1) : INT_MAX;
+    numThreads = 0;
+
+    for (tbb::numa_node_id numaNodeID : numaNodes)
+    {
+      ThreadArena threadArena;
+      threadArena.constraints.set_numa_id(numaNodeID);
+      threadArena.constraints.set_core_type(coreType);
+      if (oneThreadPerCore)
+        threadArena.constraints.set_max_threads_per_core(1);
+
+      threadArena.numThreads = min(tbb::info::default_concurrency(threadArena.constraints), maxArenaThreads);
+      threadArena.constraints.set_max_concurrency(threadArena.numThreads);
+      threadArena.arena = std::make_shared<tbb::task_arena>(threadArena.constraints);
+      threadArena.numaNodeID = numaNodeID;
+      threadArena.hybrid = coreType < 0 && tbb::info::core_types().size() > 1;
+
+      threadArenas.push_back(threadArena);
+      numThreads += threadArena.numThreads;
     }
   }
+#endif
 
   Storage CPUDevice::getPtrStorage(const void* ptr)
   {
@@ -224,6 +415,16 @@ OIDN_NAMESPACE_BEGIN
       return numThreads;
     else if (name == "setAffinity")
       return setAffinity;
+    else if (name == "numa")
+      return numa;
+    else if (name == "performanceCoresOnly")
+      return performanceCoresOnly;
+    else if (name == "maxConcurrentTiles")
+      return maxConcurrentTiles;
+    else if (name == "reducedPrecision")
+      return reducedPrecision;
+    else if (name == "autotune")
+      return autotune;
     else
       return Device::getInt(name);
   }
@@ -244,12 +445,74 @@ OIDN_NAMESPACE_BEGIN
       else if (setAffinity != bool(value))
         printWarning("OIDN_SET_AFFINITY environment variable overrides device parameter");
     }
+    else if (name == "numa")
+    {
+      if (!isEnvVar("OIDN_NUMA"))
+        numa = value;
+      else if (numa != bool(value))
+        printWarning("OIDN_NUMA environment variable overrides device parameter");
+    }
+    else if (name == "performanceCoresOnly")
+    {
+      if (!isEnvVar("OIDN_PERFORMANCE_CORES_ONLY"))
+        performanceCoresOnly = value;
+      else if (performanceCoresOnly != bool(value))
+        printWarning("OIDN_PERFORMANCE_CORES_ONLY environment variable overrides device parameter");
+    }
+    else if (name == "maxConcurrentTiles")
+    {
+      if (!isEnvVar("OIDN_MAX_CONCURRENT_TILES"))
+        maxConcurrentTiles = value;
+      else if (maxConcurrentTiles != value)
+        printWarning("OIDN_MAX_CONCURRENT_TILES environment variable overrides device parameter");
+    }
+    else if (name == "reducedPrecision")
+    {
+      if (!isEnvVar("OIDN_REDUCED_PRECISION"))
+        reducedPrecision = value;
+      else if (reducedPrecision != bool(value))
+        printWarning("OIDN_REDUCED_PRECISION environment variable overrides device parameter");
+    }
+    else if (name == "autotune")
+    {
+      if (!isEnvVar("OIDN_AUTOTUNE"))
+        autotune = value;
+      else if (autotune != bool(value))
+        printWarning("OIDN_AUTOTUNE environment variable overrides device parameter");
+    }
     else
       Device::setInt(name, value);
 
     dirty = true;
   }
 
+  void CPUDevice::submitBarrier()
+  {
+    // We need a barrier only if there are at least 2 subdevices executing asynchronously
+    const int numSubdevices = getNumSubdevices();
+    if (numSubdevices < 2 || isProfiling())
+      return;
+
+    // Get the number of functions submitted to each queue so far
+    std::vector<std::pair<CPUQueue*, size_t>> marks;
+    for (int i = 0; i < numSubdevices; ++i)
+    {
+      CPUQueue* queue = static_cast<CPUEngine*>(getEngine(i))->getQueue();
+      marks.emplace_back(queue, queue->getNumSubmitted());
+    }
+
+    // The next functions on each queue depend on the functions submitted to the other queues
+    // before the barrier
+    for (int i = 0; i < numSubdevices; ++i)
+    {
+      getEngine(i)->submitHostFunc([marks]()
+      {
+        for (const auto& mark : marks)
+          mark.first->waitFor(mark.second);
+      });
+    }
+  }
+
   void CPUDevice::wait()
   {
     for (auto& subdevice : subdevices)
@@ -18,6 +18,7 @@ OIDN_NAMESPACE_BEGIN
     SSE41,
     AVX2,
     AVX512,
+    AVX512SPR, // AVX-512 with FP16 and AMX (Sapphire Rapids)
     NEON
   };
 
@@ -37,35 +38,64 @@ OIDN_NAMESPACE_BEGIN
     static std::string getName();
     static CPUArch getArch();
 
-    CPUDevice();
+    // The parallel work is executed with the specified parallel for function of the application,
+    // if it is not null, instead of using worker threads created by the device
+    explicit CPUDevice(ParallelForFunction parallelForFunc = nullptr, void* parallelForUserPtr = nullptr);
     ~CPUDevice();
 
     DeviceType getType() const override { return DeviceType::CPU; }
 
   #if !defined(OIDN_DNNL)
-    bool needWeightAndBiasOnDevice() const override { return false; } // no need to copy
+    // No need to copy, except to the memory of each NUMA node
+    bool needWeightAndBiasOnDevice() const override { return threadArenas.size() > 1; }
   #endif
     Storage getPtrStorage(const void* ptr) override;
 
     int getInt(const std::string& name) override;
     void setInt(const std::string& name, int value) override;
 
+    void submitBarrier() override;
     void wait() override;
 
   protected:
     void init() override;
     void initTasking();
+    void initExternalTasking();
+  #if TBB_INTERFACE_VERSION >= 12020
+    void initConstrainedArenas(const std::vector<tbb::numa_node_id>& numaNodes, tbb::core_type_id coreType);
+  #endif
 
   private:
     CPUArch arch = CPUArch::Unknown;
 
+    // Thread arena used by a subdevice
+    struct ThreadArena
+    {
+      std::shared_ptr<tbb::task_arena> arena;
+      int numThreads;
+      int numaNodeID; // -1 if not bound to a NUMA node
+      bool hybrid;    // has threads running on different core types?
+    #if TBB_INTERFACE_VERSION >= 12020
+      tbb::task_arena::constraints constraints; // also used for the nested arenas
+    #endif
+    };
+
     // Tasking
-    std::shared_ptr<tbb::task_arena> arena;
+    // In NUMA-aware mode, there is a separate arena and subdevice for each NUMA node
+    std::vector<ThreadArena> threadArenas;
+    std::unique_ptr<ParallelFor> parallelFor; // parallel for function of the application (optional)
     std::shared_ptr<PinningObserver> observer;
     std::shared_ptr<ThreadAffinity> affinity;
 
     int numThreads = 0; // autodetect by default
     bool setAffinity = true;
+    bool numa = false;  // create a subdevice for each NUMA node
+    bool performanceCoresOnly = false; // use only the most performant cores of hybrid CPUs
+    int maxConcurrentTiles = 0; // autodetect by default
+    bool reducedPrecision = false; // store activations and weights in FP16 if supported
+    bool autotune = false;         // select the convolution blocking parameters by benchmarking
+
+    static constexpr int minTileThreads = 16; // minimum number of threads per concurrently processed tile
   };
 
 OIDN_NAMESPACE_END
@@ -4,6 +4,10 @@
 #include "cpu_engine.h"
 #if !defined(OIDN_DNNL) && !defined(OIDN_BNNS)
   #include "cpu_conv.h"
+  #include "cpu_conv_chain.h"
+  #include "cpu_int8_conv.h"
+  #include "cpu_task_graph.h"
+  #include "cpu_winograd_conv.h"
 #endif
 #include "cpu_pool.h"
 #include "cpu_upsample.h"
@@ -14,23 +18,265 @@
 
 OIDN_NAMESPACE_BEGIN
 
-  CPUEngine::CPUEngine(CPUDevice* device)
+  CPUEngine::CPUEngine(CPUDevice* device, int arenaIndex)
     : device(device)
-  {}
+  {
+    const auto& threadArena = device->threadArenas.at(arenaIndex);
+    arena       = threadArena.arena;
+    parallelFor = device->parallelFor.get();
+    numThreads  = threadArena.numThreads;
+    numaNodeID = threadArena.numaNodeID;
+    hybrid     = threadArena.hybrid;
+  #if TBB_INTERFACE_VERSION >= 12020
+    arenaConstraints = threadArena.constraints;
+  #endif
+
+    // Profiling synchronizes after each operation anyway, so it is simpler to execute everything
+    // immediately in that case
+    if (!device->isProfiling())
+      queue.reset(new CPUQueue(arena, parallelFor));
+
+  #if !defined(OIDN_DNNL) && !defined(OIDN_BNNS)
+    // The tuned parameters are cached persistently together with the weights
+    if (device->autotune)
+      convTuner.reset(new CPUConvTuner(device, device->getWeightsCacheDir()));
+  #endif
+  }
 
   void CPUEngine::runHostTask(std::function<void()>&& f)
   {
-    if (device->arena)
-      device->arena->execute(f);
+    if (arena)
+      arena->execute([&]() { execute(f); });
+    else
+      execute(f);
+  }
+
+  void CPUEngine::execute(const std::function<void()>& f)
+  {
+    if (parallelFor)
+      parallelFor->execute(f);
     else
       f();
   }
 
+  void CPUEngine::runConcurrentHostTasks(int numTasks, const std::function<void(int)>& f)
+  {
+    if (numTasks <= 1)
+    {
+      Engine::runConcurrentHostTasks(numTasks, f);
+      return;
+    }
+
+    if (!queue)
+    {
+      runNestedArenas(numTasks, f);
+      return;
+    }
+
+    // Record the host functions submitted by each task, and enqueue a single host function which
+    // executes them concurrently
+    auto taskFuncs = std::make_shared<std::vector<HostFuncList>>(numTasks);
+    for (int i = 0; i < numTasks; ++i)
+      record((*taskFuncs)[i], [&]() { f(i); });
+
+    queue->submit([this, numTasks, taskFuncs]()
+    {
+      runNestedArenas(numTasks, [&](int i)
+      {
+        for (auto& func : (*taskFuncs)[i])
+          func();
+      });
+    });
+  }
+
+  void CPUEngine::runNestedArenas(int numTasks, const std::function<void(int)>& f)
+  {
+    // Create the nested arenas if necessary, each having an equal share of the threads
+    if (int(nestedArenas.size()) != numTasks)
+    {
+      nestedArenas.clear();
+      const int numArenaThreads = max(getNumThreads() / numTasks, 1);
+      for (int i = 0; i < numTasks; ++i)
+      {
+      #if TBB_INTERFACE_VERSION >= 12020
+        // Nested arenas have the same constraints (NUMA node, core type) as the arena of the engine
+        tbb::task_arena::constraints constraints = arenaConstraints;
+        constraints.set_max_concurrency(numArenaThreads);
+        nestedArenas.push_back(std::make_shared<tbb::task_arena>(constraints));
+      #else
+        nestedArenas.push_back(std::make_shared<tbb::task_arena>(numArenaThreads));
+      #endif
+      }
+    }
+
+    // Run each task in its own arena
+    tbb::parallel_for(tbb::blocked_range<int>(0, numTasks, 1), [&](const tbb::blocked_range<int>& r)
+    {
+      for (int i = r.begin(); i != r.end(); ++i)
+        nestedArenas[i]->execute([&]() { f(i); });
+    }, tbb::simple_partitioner());
+  }
+
+  void CPUEngine::runOverlappedHostTasks(const std::function<void()>& f1, const std::function<void()>& f2)
+  {
+    if (!queue)
+    {
+      tbb::parallel_invoke(f1, f2);
+      return;
+    }
+
+    // Record the host functions submitted by the tasks, and enqueue a single host function which
+    // executes them overlapped
+    auto funcs1 = std::make_shared<HostFuncList>();
+    auto funcs2 = std::make_shared<HostFuncList>();
+    record(*funcs1, f1);
+    record(*funcs2, f2);
+
+    queue->submit([funcs1, funcs2]()
+    {
+      tbb::parallel_invoke(
+        [&]() { for (auto& func : *funcs1) func(); },
+        [&]() { for (auto& func : *funcs2) func(); });
+    });
+  }
+
+  void CPUEngine::record(HostFuncList& funcs, const std::function<void()>& f)
+  {
+    // Recordings may be nested (e.g. dataflow in concurrent host tasks), the recorded host functions
+    // are added to the outer recording as part of a single host function
+    HostFuncList* prevRecordedFuncs = recordedFuncs;
+    recordedFuncs = &funcs;
+    try
+    {
+      f();
+    }
+    catch (...)
+    {
+      recordedFuncs = prevRecordedFuncs;
+      throw;
+    }
+    recordedFuncs = prevRecordedFuncs;
+  }
+
 #if !defined(OIDN_DNNL) && !defined(OIDN_BNNS)
+  bool CPUEngine::isConvSupported(PostOp postOp)
+  {
+    return postOp == PostOp::None ||
+           postOp == PostOp::Pool ||
+           postOp == PostOp::Upsample;
+  }
+
   Ref<Conv> CPUEngine::newConv(const ConvDesc& desc)
   {
+    // Use INT8 quantized convolution if the source has been calibrated (only in fast quality mode)
+    if (CPUInt8Conv::isApplicable(desc))
+      return makeRef<CPUInt8Conv>(this, desc);
+
+    // Use the faster but less accurate Winograd convolution only if fast math is enabled
+    // It requires the TBB thread indices, which are not available with a parallel for function
+    if (desc.fastMath && !parallelFor && CPUWinogradConv::isApplicable(desc))
+      return makeRef<CPUWinogradConv>(this, desc);
     return makeRef<CPUConv>(this, desc);
   }
+
+  bool CPUEngine::isConvChainSupported(const std::vector<ConvDesc>& convDescs)
+  {
+    // Chains are always executed with direct FP32 convolutions, thus it is faster to execute the
+    // convolutions separately if some of them could use Winograd or INT8 instead
+    for (const auto& desc : convDescs)
+    {
+      if ((desc.fastMath && !parallelFor && CPUWinogradConv::isApplicable(desc)) ||
+          CPUInt8Conv::isApplicable(desc))
+        return false;
+    }
+    return true;
+  }
+
+  Ref<ConvChain> CPUEngine::newConvChain(const std::vector<ConvDesc>& convDescs)
+  {
+    return makeRef<CPUConvChain>(this, convDescs);
+  }
+
+  bool CPUEngine::isDataflowSupported() const
+  {
+    // Without a queue the operations must be executed immediately when submitted, and the tasks
+    // cannot be scheduled with a parallel for function
+    return queue != nullptr && !parallelFor;
+  }
+
+  void CPUEngine::submitDataflow(const std::vector<Ref<Op>>& ops, const std::vector<std::vector<OpDep>>& opDeps)
+  {
+    // Maximum number of row blocks of an operation, each computed by a separate (parallel) task
+    constexpr int maxRowBlocks = 8;
+
+    // Split the row operations into blocks of rows, each depending only on the row blocks of the
+    // sources it reads, and record the other operations as single tasks
+    auto taskGraph = std::make_shared<CPUTaskGraph>();
+    std::vector<CPURowOp*> rowOps(ops.size());
+    std::vector<int> rowBlockSizes(ops.size(), 0);
+    std::vector<std::vector<int>> opTasks(ops.size()); // indices of the tasks of each operation
+
+    for (size_t i = 0; i < ops.size(); ++i)
+    {
+      CPURowOp* rowOp = rowOps[i] = getCPURowOp(ops[i].get());
+
+      if (rowOp)
+      {
+        const int numRows = rowOp->getNumRows();
+        const int rowBlockSize = round_up(ceil_div(numRows, maxRowBlocks), rowOp->getRowAlignment());
+        rowBlockSizes[i] = rowBlockSize;
+        auto rowFunc = rowOp->getRowFunc();
+
+        for (int rowBegin = 0; rowBegin < numRows; rowBegin += rowBlockSize)
+        {
+          const int rowEnd = min(rowBegin + rowBlockSize, numRows);
+          const int taskIndex = taskGraph->addTask([=]() { rowFunc(rowBegin, rowEnd); });
+          opTasks[i].push_back(taskIndex);
+
+          int srcRowBegin, srcRowEnd;
+          rowOp->getSrcRows(rowBegin, rowEnd, srcRowBegin, srcRowEnd);
+
+          for (const auto& dep : opDeps[i])
+          {
+            const auto& predTasks = opTasks[dep.opIndex];
+            if (dep.rowwise && rowOps[dep.opIndex])
+            {
+              const int predRowBlockSize = rowBlockSizes[dep.opIndex];
+              const int firstBlock = max(srcRowBegin, 0) / predRowBlockSize;
+              const int lastBlock  = min(ceil_div(srcRowEnd, predRowBlockSize), int(predTasks.size()));
+              for (int b = firstBlock; b < lastBlock; ++b)
+                taskGraph->addDep(taskIndex, predTasks[b]);
+            }
+            else
+            {
+              for (int predTaskIndex : predTasks)
+                taskGraph->addDep(taskIndex, predTaskIndex);
+            }
+          }
+        }
+      }
+      else
+      {
+        auto funcs = std::make_shared<HostFuncList>();
+        record(*funcs, [&]() { ops[i]->submit(); });
+
+        const int taskIndex = taskGraph->addTask([funcs]()
+        {
+          for (auto& func : *funcs)
+            func();
+        });
+        opTasks[i].push_back(taskIndex);
+
+        for (const auto& dep : opDeps[i])
+        {
+          for (int predTaskIndex : opTasks[dep.opIndex])
+            taskGraph->addDep(taskIndex, predTaskIndex);
+        }
+      }
+    }
+
+    submitHostFunc([taskGraph]() { taskGraph->run(); });
+  }
 #endif
 
   Ref<Pool> CPUEngine::newPool(const PoolDesc& desc)
@@ -65,7 +311,32 @@ OIDN_NAMESPACE_BEGIN
 
   void CPUEngine::submitHostFunc(std::function<void()>&& f)
   {
-    f(); // no async execution on the CPU
+    if (recordedFuncs)
+      recordedFuncs->push_back(std::move(f));
+    else if (queue)
+      queue->submit(std::move(f));
+    else
+      execute(f);
+  }
+
+  void CPUEngine::cancelSubmitted()
+  {
+    if (queue)
+      queue->cancel();
+  }
+
+#if !defined(OIDN_DNNL) && !defined(OIDN_BNNS)
+  void CPUEngine::saveTuning()
+  {
+    if (convTuner)
+      convTuner->save();
+  }
+#endif
+
+  void CPUEngine::wait()
+  {
+    if (queue)
+      queue->wait();
   }
 
   void* CPUEngine::usmAlloc(size_t byteSize, Storage storage)
@@ -75,7 +346,28 @@ OIDN_NAMESPACE_BEGIN
 
     if (byteSize == 0)
       return nullptr;
-    return alignedMalloc(byteSize);
+
+    void* ptr = alignedMalloc(byteSize);
+    if (numaNodeID >= 0)
+      touchPages(ptr, byteSize);
+    return ptr;
+  }
+
+  void CPUEngine::touchPages(void* ptr, size_t byteSize)
+  {
+    // The OS places the pages in the memory of the NUMA node which touches them first, so touch
+    // them in the arena bound to the node of the engine
+    constexpr size_t pageByteSize = 4096;
+    char* bytePtr = static_cast<char*>(ptr);
+    const size_t numPages = ceil_div(byteSize, pageByteSize);
+
+    arena->execute([&]()
+    {
+      parallel_nd(numPages, [&](size_t i)
+      {
+        bytePtr[i * pageByteSize] = 0;
+      });
+    });
   }
 
   void CPUEngine::usmFree(void* ptr, Storage storage)
@@ -86,12 +378,13 @@ OIDN_NAMESPACE_BEGIN
 
   void CPUEngine::usmCopy(void* dstPtr, const void* srcPtr, size_t byteSize)
   {
-    std::memcpy(dstPtr, srcPtr, byteSize);
+    submitUSMCopy(dstPtr, srcPtr, byteSize);
+    wait();
   }
 
   void CPUEngine::submitUSMCopy(void* dstPtr, const void* srcPtr, size_t byteSize)
   {
-    std::memcpy(dstPtr, srcPtr, byteSize);
+    submitHostFunc([=]() { std::memcpy(dstPtr, srcPtr, byteSize); });
   }
 
 OIDN_NAMESPACE_END
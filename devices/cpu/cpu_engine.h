@@ -5,20 +5,37 @@
 
 #include "core/engine.h"
 #include "cpu_device.h"
+#include "cpu_queue.h"
+#include "cpu_conv_tuner.h"
 
 OIDN_NAMESPACE_BEGIN
 
   class CPUEngine : public Engine
   {
   public:
-    explicit CPUEngine(CPUDevice* device);
+    // The engine uses the specified thread arena of the device
+    explicit CPUEngine(CPUDevice* device, int arenaIndex = 0);
 
     Device* getDevice() const override { return device; }
-    int getNumThreads() const { return device->numThreads; }
+    int getNumThreads() const { return numThreads; }
+
+    // Returns whether the threads run on different core types with different performance
+    bool isHybrid() const { return hybrid; }
 
     // Ops
   #if !defined(OIDN_DNNL) && !defined(OIDN_BNNS)
+    bool isConvSupported(PostOp postOp) override;
     Ref<Conv> newConv(const ConvDesc& desc) override;
+    bool isConvChainSupported(const std::vector<ConvDesc>& convDescs) override;
+    Ref<ConvChain> newConvChain(const std::vector<ConvDesc>& convDescs) override;
+
+    // Schedules the operations as a graph of tasks computing blocks of rows, thus threads do not
+    // have to wait for all rows of an operation before starting the next one
+    bool isDataflowSupported() const override;
+    void submitDataflow(const std::vector<Ref<Op>>& ops, const std::vector<std::vector<OpDep>>& opDeps) override;
+
+    // Auto-tuning of the convolution blocking parameters (null if disabled)
+    CPUConvTuner* getConvTuner() const { return convTuner.get(); }
   #endif
     Ref<Pool> newPool(const PoolDesc& desc) override;
     Ref<Upsample> newUpsample(const UpsampleDesc& desc) override;
@@ -36,13 +53,61 @@ OIDN_NAMESPACE_BEGIN
     // Runs a parallel host task in the thread arena (if it exists)
     void runHostTask(std::function<void()>&& f) override;
 
-    // Enqueues a host function
+    // Runs host tasks concurrently in nested thread arenas partitioning the threads of the device
+    int getMaxConcurrentHostTasks() const override { return device->maxConcurrentTiles; }
+    void runConcurrentHostTasks(int numTasks, const std::function<void(int)>& f) override;
+
+    // Overlaps host tasks in the same thread arena, thus idle threads of one task steal the work of
+    // the other task
+    bool canOverlapHostTasks() const override { return !parallelFor; }
+    void runOverlappedHostTasks(const std::function<void()>& f1, const std::function<void()>& f2) override;
+
+    // Enqueues a host function, which is executed asynchronously by the queue of the engine
+    // All operations of the engine are executed as host functions
     void submitHostFunc(std::function<void()>&& f) override;
+    void cancelSubmitted() override;
+
+  #if !defined(OIDN_DNNL) && !defined(OIDN_BNNS)
+    void saveTuning() override;
+  #endif
+
+    void wait() override;
 
-    void wait() override {}
+    // Queue of the engine (null if host functions are executed immediately)
+    CPUQueue* getQueue() const { return queue.get(); }
 
   protected:
     CPUDevice* device;
+
+  private:
+    using HostFuncList = std::vector<std::function<void()>>;
+
+    // Runs a host task and records the host functions it submits instead of enqueueing them
+    void record(HostFuncList& funcs, const std::function<void()>& f);
+    void execute(const std::function<void()>& f);
+    void runNestedArenas(int numTasks, const std::function<void(int)>& f);
+
+    // Touches the pages of newly allocated memory from the threads of the NUMA node
+    void touchPages(void* ptr, size_t byteSize);
+
+    std::shared_ptr<tbb::task_arena> arena;
+    const ParallelFor* parallelFor; // parallel for function of the application (optional)
+    int numThreads;
+    int numaNodeID;
+    bool hybrid;
+  #if TBB_INTERFACE_VERSION >= 12020
+    tbb::task_arena::constraints arenaConstraints;
+  #endif
+    std::vector<std::shared_ptr<tbb::task_arena>> nestedArenas; // for concurrent host tasks
+
+    // Asynchronous execution
+    // Without a queue (e.g. when profiling), host functions are executed immediately
+    std::unique_ptr<CPUQueue> queue;
+    HostFuncList* recordedFuncs = nullptr; // if set, submitted host functions are recorded here
+
+  #if !defined(OIDN_DNNL) && !defined(OIDN_BNNS)
+    std::unique_ptr<CPUConvTuner> convTuner;
+  #endif
   };
 
 OIDN_NAMESPACE_END
@@ -13,6 +13,9 @@ OIDN_NAMESPACE_BEGIN
   public:
     explicit CPUImageCopy(CPUEngine* engine);
     void submit() override;
+
+  private:
+    CPUEngine* engine;
   };
 
 OIDN_NAMESPACE_END
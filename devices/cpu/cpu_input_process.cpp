@@ -8,7 +8,8 @@
 OIDN_NAMESPACE_BEGIN
 
   CPUInputProcess::CPUInputProcess(CPUEngine* engine, const InputProcessDesc& desc)
-    : InputProcess(engine, desc) {}
+    : InputProcess(engine, desc),
+      engine(engine) {}
 
   void CPUInputProcess::submit()
   {
@@ -25,10 +26,14 @@ OIDN_NAMESPACE_BEGIN
     kernel.transferFunc = toISPC(*transferFunc);
     kernel.hdr   = hdr;
     kernel.snorm = snorm;
+    kernel.keepAux = keepAux;
 
-    parallel_nd(kernel.dst.H, [&](int hDst)
+    engine->submitHostFunc([=]()
     {
-      ispc::CPUInputProcessKernel_run(&kernel, hDst);
+      parallel_nd(kernel.dst.H, [&](int hDst)
+      {
+        ispc::CPUInputProcessKernel_run(&kernel, hDst);
+      });
     });
   }
 
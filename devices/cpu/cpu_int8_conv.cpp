@@ -0,0 +1,151 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "cpu_int8_conv.h"
+#include "cpu_int8_conv_ispc.h"
+
+OIDN_NAMESPACE_BEGIN
+
+  namespace
+  {
+    ispc::CPUInt8ConvPostOp toISPC(PostOp postOp)
+    {
+      switch (postOp)
+      {
+      case PostOp::None:     return ispc::CPUInt8ConvPostOp_None;
+      case PostOp::Pool:     return ispc::CPUInt8ConvPostOp_Pool;
+      case PostOp::Upsample: return ispc::CPUInt8ConvPostOp_Upsample;
+      default:
+        throw std::invalid_argument("unsupported convolution postop");
+      }
+    }
+  }
+
+  bool CPUInt8Conv::isApplicable(const ConvDesc& desc)
+  {
+    // The kernels are faster than FP32 only with native 8-bit dot product instructions (VNNI)
+    return desc.srcScale > 0.f &&
+           CPUDevice::getArch() == CPUArch::AVX512SPR &&
+           (desc.srcDesc.dataType == DataType::Float32 || desc.srcDesc.dataType == DataType::Float16) &&
+           desc.weightDesc.getH() == 3 && desc.weightDesc.getW() == 3;
+  }
+
+  CPUInt8Conv::CPUInt8Conv(CPUEngine* engine, const ConvDesc& desc)
+    : Conv(desc),
+      engine(engine)
+  {
+    const DataType dataType = srcDesc.dataType;
+    if ((srcDesc.layout != TensorLayout::Chw8c &&
+         srcDesc.layout != TensorLayout::Chw16c) ||
+        (dataType != DataType::Float32 && dataType != DataType::Float16))
+      throw std::invalid_argument("unsupported convolution source layout/data type");
+    if (weightDesc.getW() != 3 || weightDesc.getH() != 3)
+      throw std::invalid_argument("unsupported convolution kernel size");
+    if ((weightDesc.layout != TensorLayout::IOhw8i8o &&
+         weightDesc.layout != TensorLayout::IOhw16i16o) || weightDesc.dataType != dataType)
+      throw std::invalid_argument("unsupported convolution weight layout/data type");
+    if (biasDesc.layout != TensorLayout::x || biasDesc.dataType != dataType)
+      throw std::invalid_argument("unsupported convolution bias layout/data type");
+    if (!(srcScale > 0.f))
+      throw std::invalid_argument("invalid convolution source scale");
+
+    blockOW = ispc::CPUInt8ConvKernel_getBlockOW();
+    OWB = ceil_div(srcDesc.getW(), blockOW);
+
+    // The quantized source has a 1-pixel zero border, and its width is padded to a multiple of
+    // the width block, so the kernel does not have to check the bounds
+    paddedW = OWB * blockOW + 2;
+  }
+
+  size_t CPUInt8Conv::getScratchByteSize() const
+  {
+    return round_up(size_t(srcDesc.getPaddedC()) * (srcDesc.getH() + 2) * paddedW, memoryAlignment);
+  }
+
+  void CPUInt8Conv::setScratch(const Ref<Buffer>& scratch)
+  {
+    if (scratch && scratch->getByteSize() < getScratchByteSize())
+      throw std::invalid_argument("convolution scratch buffer too small");
+    this->scratch = scratch;
+  }
+
+  size_t CPUInt8Conv::getQuantizedWeightByteSize() const
+  {
+    return round_up(size_t(weightDesc.getPaddedO()) * weightDesc.getPaddedI() * 9, memoryAlignment);
+  }
+
+  TensorDesc CPUInt8Conv::getPackedWeightDesc() const
+  {
+    const size_t byteSize = getQuantizedWeightByteSize() + size_t(weightDesc.getPaddedO()) * sizeof(float);
+    return {{int(byteSize)}, TensorLayout::x, DataType::UInt8};
+  }
+
+  // Quantizes the weights only once, instead of at every execution
+  void CPUInt8Conv::packWeight(Tensor& packedWeight) const
+  {
+    if (!weight)
+      throw std::logic_error("convolution weight not set");
+    if (packedWeight.getDesc() != getPackedWeightDesc())
+      throw std::invalid_argument("invalid convolution packed weight");
+
+    const int blockC = getTensorLayoutInfo(weightDesc.layout).blockC;
+    const int OCB = weightDesc.getPaddedO() / blockC;
+
+    ispc::TensorAccessor4D weightAcc = *weight;
+    char* packedWeightPtr = static_cast<char*>(packedWeight.getPtr());
+    uint32_t* quantizedWeightPtr = reinterpret_cast<uint32_t*>(packedWeightPtr);
+    float* weightScalePtr = reinterpret_cast<float*>(packedWeightPtr + getQuantizedWeightByteSize());
+
+    parallel_nd(OCB, [&](int ocb)
+    {
+      ispc::CPUInt8ConvKernel_quantizeWeight(weightAcc, srcScale, quantizedWeightPtr, weightScalePtr, ocb);
+    });
+  }
+
+  void CPUInt8Conv::submit()
+  {
+    if (!src || !dst)
+      throw std::logic_error("convolution source/destination not set");
+    if (!weight || !bias)
+      throw std::logic_error("convolution weight/bias not set");
+    if (!scratch)
+      throw std::logic_error("convolution scratch not set");
+
+    const char* packedWeightPtr = static_cast<const char*>(getPackedWeight()->getPtr());
+
+    ispc::CPUInt8ConvKernel kernel;
+    kernel.src     = static_cast<uint8_t*>(scratch->getPtr());
+    kernel.weight  = reinterpret_cast<const uint32_t*>(packedWeightPtr);
+    kernel.scale   = reinterpret_cast<const float*>(packedWeightPtr + getQuantizedWeightByteSize());
+    kernel.bias    = *bias;
+    kernel.dst     = *dst;
+    kernel.IC      = srcDesc.getPaddedC();
+    kernel.H       = srcDesc.getH();
+    kernel.W       = srcDesc.getW();
+    kernel.paddedW = paddedW;
+    kernel.relu    = activation == Activation::ReLU;
+    kernel.postOp  = toISPC(postOp);
+
+    const ispc::TensorAccessor3D srcAcc = *src;
+    const float invSrcScale = 1.f / srcScale;
+    const int blockC = getTensorLayoutInfo(srcDesc.layout).blockC;
+    const int ICB = srcDesc.getPaddedC() / blockC;
+    const int H = srcDesc.getH();
+    const int numRows = (postOp == PostOp::Pool) ? dstDesc.getH() : H; // rows computed at once
+    const int OWB = this->OWB;
+
+    engine->submitHostFunc([=]()
+    {
+      parallel_nd(ICB, H + 2, [&](int icb, int hp)
+      {
+        ispc::CPUInt8ConvKernel_quantizeSrc(&kernel, srcAcc, invSrcScale, icb, hp);
+      });
+
+      parallel_nd(numRows, OWB, [&](int row, int owb)
+      {
+        ispc::CPUInt8ConvKernel_run(&kernel, row, owb);
+      });
+    });
+  }
+
+OIDN_NAMESPACE_END
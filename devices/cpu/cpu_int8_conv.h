@@ -0,0 +1,44 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "core/conv.h"
+#include "cpu_engine.h"
+
+OIDN_NAMESPACE_BEGIN
+
+  // INT8 quantized convolution using the calibrated scale of the source and per-output-channel
+  // weight scales, which is faster but less accurate than FP32 convolution on CPUs with VNNI
+  // The source is quantized into the scratch before the convolution, and the accumulated results
+  // are dequantized in the epilogue, thus the destination has the same data type as the source.
+  class CPUInt8Conv final : public Conv
+  {
+  public:
+    // Checks whether the convolution can be computed with INT8 efficiently
+    static bool isApplicable(const ConvDesc& desc);
+
+    CPUInt8Conv(CPUEngine* engine, const ConvDesc& desc);
+
+    size_t getScratchByteSize() const override;
+    void setScratch(const Ref<Buffer>& scratch) override;
+
+    // The packed weight contains the quantized weights followed by the dequantization scale of
+    // each output channel
+    TensorDesc getPackedWeightDesc() const override;
+    std::string getPackedWeightSuffix() const override { return ".int8_weight"; }
+    void packWeight(Tensor& packedWeight) const override;
+
+    void submit() override;
+
+  private:
+    size_t getQuantizedWeightByteSize() const;
+
+    CPUEngine* engine;
+    int blockOW;  // block of output width (before the post-op)
+    int OWB;      // number of output width blocks
+    int paddedW;  // width of the quantized source including the border
+    Ref<Buffer> scratch;
+  };
+
+OIDN_NAMESPACE_END
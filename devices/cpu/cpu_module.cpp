@@ -6,7 +6,7 @@
 
 OIDN_NAMESPACE_BEGIN
 
-  class CPUDeviceFactory : public DeviceFactory
+  class CPUDeviceFactory : public CPUDeviceFactoryBase
   {
   public:
     Ref<Device> newDevice() override
@@ -19,6 +19,11 @@ OIDN_NAMESPACE_BEGIN
       assert(physicalDevice->type == DeviceType::CPU);
       return makeRef<CPUDevice>();
     }
+
+    Ref<Device> newDevice(ParallelForFunction parallelForFunc, void* parallelForUserPtr) override
+    {
+      return makeRef<CPUDevice>(parallelForFunc, parallelForUserPtr);
+    }
   };
 
   OIDN_DECLARE_INIT_STATIC_MODULE(device_cpu)
@@ -8,7 +8,8 @@
 OIDN_NAMESPACE_BEGIN
 
   CPUOutputProcess::CPUOutputProcess(CPUEngine* engine, const OutputProcessDesc& desc)
-    : OutputProcess(desc) {}
+    : OutputProcess(desc),
+      engine(engine) {}
 
   void CPUOutputProcess::submit()
   {
@@ -23,9 +24,12 @@ OIDN_NAMESPACE_BEGIN
     kernel.hdr = hdr;
     kernel.snorm = snorm;
 
-    parallel_nd(kernel.tile.H, [&](int h)
+    engine->submitHostFunc([=]()
     {
-      ispc::CPUOutputProcessKernel_run(&kernel, h);
+      parallel_nd(kernel.tile.B * kernel.tile.H, [&](int hTile)
+      {
+        ispc::CPUOutputProcessKernel_run(&kernel, hTile);
+      });
     });
   }
 
@@ -8,7 +8,8 @@
 OIDN_NAMESPACE_BEGIN
 
   CPUPool::CPUPool(CPUEngine* engine, const PoolDesc& desc)
-    : Pool(desc)
+    : Pool(desc),
+      engine(engine)
   {
     if (srcDesc.layout != TensorLayout::Chw8c &&
         srcDesc.layout != TensorLayout::Chw16c)
@@ -26,9 +27,15 @@ OIDN_NAMESPACE_BEGIN
     kernel.src = *src;
     kernel.dst = *dst;
 
-    parallel_nd(dst->getPaddedC() / blockC, dst->getH(), [&](int cb, int h)
+    const int CB = dst->getPaddedC() / blockC;
+    const int H  = dst->getH();
+
+    engine->submitHostFunc([=]()
     {
-      ispc::CPUPoolKernel_run(&kernel, cb, h);
+      parallel_nd(CB, H, [&](int cb, int h)
+      {
+        ispc::CPUPoolKernel_run(&kernel, cb, h);
+      });
     });
   }
 
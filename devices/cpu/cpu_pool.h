@@ -13,6 +13,9 @@ OIDN_NAMESPACE_BEGIN
   public:
     CPUPool(CPUEngine* engine, const PoolDesc& desc);
     void submit() override;
+
+  private:
+    CPUEngine* engine;
   };
 
 OIDN_NAMESPACE_END
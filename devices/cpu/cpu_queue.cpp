@@ -0,0 +1,132 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "cpu_queue.h"
+
+OIDN_NAMESPACE_BEGIN
+
+  CPUQueue::CPUQueue(const std::shared_ptr<tbb::task_arena>& arena, const ParallelFor* parallelFor)
+    : arena(arena),
+      parallelFor(parallelFor),
+      thread([this]() { run(); }) {}
+
+  CPUQueue::~CPUQueue()
+  {
+    // The remaining functions are executed before the submission thread stops
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopped = true;
+    }
+    submitCond.notify_one();
+    thread.join();
+  }
+
+  void CPUQueue::submit(std::function<void()>&& f)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      ++numSubmitted;
+      if (error)
+      {
+        ++numDone; // the function depends on a failed one
+        return;
+      }
+      funcs.push_back(std::move(f));
+    }
+    submitCond.notify_one();
+  }
+
+  void CPUQueue::cancel()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    numDone += funcs.size();
+    funcs.clear();
+    if (!error)
+      error = std::make_exception_ptr(Exception(Error::Cancelled, "execution was cancelled"));
+  }
+
+  void CPUQueue::wait()
+  {
+    // Waiting from a submitted function would deadlock, and the preceding functions have already
+    // completed anyway
+    if (std::this_thread::get_id() == thread.get_id())
+      return;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    doneCond.wait(lock, [&]() { return funcs.empty() && !busy; });
+
+    if (error)
+    {
+      std::exception_ptr curError = error;
+      error = nullptr;
+      std::rethrow_exception(curError);
+    }
+  }
+
+  size_t CPUQueue::getNumSubmitted()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    return numSubmitted;
+  }
+
+  void CPUQueue::waitFor(size_t numFuncs)
+  {
+    if (std::this_thread::get_id() == thread.get_id())
+      return;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    doneCond.wait(lock, [&]() { return numDone >= numFuncs; });
+  }
+
+  void CPUQueue::run()
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    for (;;)
+    {
+      submitCond.wait(lock, [&]() { return stopped || !funcs.empty(); });
+      if (funcs.empty())
+        break; // stopped
+
+      std::function<void()> f = std::move(funcs.front());
+      funcs.pop_front();
+      busy = true;
+      lock.unlock();
+
+      std::exception_ptr curError;
+      try
+      {
+        auto execute = [&]()
+        {
+          if (parallelFor)
+            parallelFor->execute(f);
+          else
+            f();
+        };
+
+        if (arena)
+          arena->execute(execute);
+        else
+          execute();
+      }
+      catch (...)
+      {
+        curError = std::current_exception();
+      }
+
+      lock.lock();
+      busy = false;
+      ++numDone;
+
+      if (curError && !error)
+      {
+        error = curError;
+        numDone += funcs.size();
+        funcs.clear();
+      }
+
+      doneCond.notify_all();
+    }
+  }
+
+OIDN_NAMESPACE_END
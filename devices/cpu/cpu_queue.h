@@ -0,0 +1,67 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "core/exception.h"
+#include "tasking.h"
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+OIDN_NAMESPACE_BEGIN
+
+  // In-order queue of host functions, which are executed asynchronously in the thread arena of the
+  // device by a dedicated submission thread, optionally using the parallel for function of the
+  // application
+  class CPUQueue final
+  {
+  public:
+    explicit CPUQueue(const std::shared_ptr<tbb::task_arena>& arena,
+                      const ParallelFor* parallelFor = nullptr);
+    ~CPUQueue();
+
+    // Enqueues a function (does not block)
+    void submit(std::function<void()>&& f);
+
+    // Discards the functions which have not started executing yet, and reports the cancellation
+    // when waiting (can be called from a submitted function)
+    void cancel();
+
+    // Waits for all submitted functions to complete (blocks)
+    // If a function threw an exception, the functions submitted after it are discarded, and the
+    // exception is rethrown
+    void wait();
+
+    // Returns the number of functions submitted so far, which can be used as a marker for waitFor
+    size_t getNumSubmitted();
+
+    // Waits for the first numFuncs submitted functions to complete or to be discarded (blocks)
+    // Errors are not reported, only by wait
+    void waitFor(size_t numFuncs);
+
+  private:
+    // Disable copying
+    CPUQueue(const CPUQueue&) = delete;
+    CPUQueue& operator =(const CPUQueue&) = delete;
+
+    void run();
+
+    std::shared_ptr<tbb::task_arena> arena;
+    const ParallelFor* parallelFor;
+    std::deque<std::function<void()>> funcs; // functions waiting for execution
+    bool busy = false;                       // is a function being executed?
+    size_t numSubmitted = 0;                 // number of functions submitted so far
+    size_t numDone = 0;                      // number of functions completed or discarded so far
+    bool stopped = false;                    // has the submission thread been requested to stop?
+    std::exception_ptr error;                // first exception thrown since the last wait
+
+    std::mutex mutex;
+    std::condition_variable submitCond; // signaled when a function is submitted or stopping
+    std::condition_variable doneCond;   // signaled when all functions have completed
+    std::thread thread;                 // must be declared last / created after everything else
+  };
+
+OIDN_NAMESPACE_END
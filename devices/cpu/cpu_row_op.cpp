@@ -0,0 +1,18 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "cpu_row_op.h"
+#include "core/concat_conv_chw.h"
+
+OIDN_NAMESPACE_BEGIN
+
+  CPURowOp* getCPURowOp(Op* op)
+  {
+    // Concatenation + convolution with pre-concatenated sources is just a convolution
+    if (auto concatConv = dynamic_cast<ConcatConvCHW*>(op))
+      return dynamic_cast<CPURowOp*>(concatConv->getConv());
+
+    return dynamic_cast<CPURowOp*>(op);
+  }
+
+OIDN_NAMESPACE_END
@@ -0,0 +1,36 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "core/op.h"
+#include <functional>
+
+OIDN_NAMESPACE_BEGIN
+
+  // Interface of operations whose destination can be computed in independent ranges of rows, which
+  // makes it possible to start computing some rows as soon as the source rows they need are ready
+  class CPURowOp
+  {
+  public:
+    virtual ~CPURowOp() = default;
+
+    // Number of rows of the destination
+    virtual int getNumRows() const = 0;
+
+    // Row ranges must be aligned to this number of rows (except at the end)
+    virtual int getRowAlignment() const { return 1; }
+
+    // Gets the range of source rows needed to compute the specified range of destination rows,
+    // which may extend beyond the source
+    virtual void getSrcRows(int rowBegin, int rowEnd, int& srcRowBegin, int& srcRowEnd) const = 0;
+
+    // Returns a function which computes a range of destination rows using the current sources and
+    // destination of the operation (must be called from a host function)
+    virtual std::function<void(int, int)> getRowFunc() = 0;
+  };
+
+  // Returns the row operation interface of an operation, or null if not supported
+  CPURowOp* getCPURowOp(Op* op);
+
+OIDN_NAMESPACE_END
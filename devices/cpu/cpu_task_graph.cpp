@@ -0,0 +1,60 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "cpu_task_graph.h"
+#include "tasking.h"
+#include <algorithm>
+
+OIDN_NAMESPACE_BEGIN
+
+  int CPUTaskGraph::addTask(std::function<void()>&& func)
+  {
+    tasks.emplace_back();
+    tasks.back().func = std::move(func);
+    return int(tasks.size()) - 1;
+  }
+
+  void CPUTaskGraph::addDep(int taskIndex, int predTaskIndex)
+  {
+    if (predTaskIndex >= taskIndex)
+      throw std::logic_error("invalid task dependency");
+
+    auto& predSuccs = tasks[predTaskIndex].succs;
+    if (std::find(predSuccs.begin(), predSuccs.end(), taskIndex) != predSuccs.end())
+      return; // already added
+
+    predSuccs.push_back(taskIndex);
+    tasks[taskIndex].numPreds++;
+  }
+
+  void CPUTaskGraph::run()
+  {
+    // The counters are reset at each run
+    std::unique_ptr<std::atomic<int>[]> numPendingPreds(new std::atomic<int>[tasks.size()]);
+    for (size_t i = 0; i < tasks.size(); ++i)
+      numPendingPreds[i] = tasks[i].numPreds;
+
+    tbb::task_group group;
+
+    std::function<void(int)> runTask = [&](int taskIndex)
+    {
+      tasks[taskIndex].func();
+
+      // Spawn the successors which do not have to wait for other tasks anymore
+      for (int succIndex : tasks[taskIndex].succs)
+      {
+        if (--numPendingPreds[succIndex] == 0)
+          group.run([&runTask, succIndex]() { runTask(succIndex); });
+      }
+    };
+
+    for (int i = 0; i < int(tasks.size()); ++i)
+    {
+      if (tasks[i].numPreds == 0)
+        group.run([&runTask, i]() { runTask(i); });
+    }
+
+    group.wait();
+  }
+
+OIDN_NAMESPACE_END
@@ -0,0 +1,39 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "common/platform.h"
+#include <functional>
+#include <vector>
+#include <atomic>
+#include <memory>
+
+OIDN_NAMESPACE_BEGIN
+
+  // Graph of tasks where each task is executed as soon as all of its predecessors have completed,
+  // instead of waiting for all previously added tasks
+  class CPUTaskGraph
+  {
+  public:
+    // Adds a task and returns its index
+    int addTask(std::function<void()>&& func);
+
+    // Adds a dependency between two tasks, the predecessor must have been added first
+    void addDep(int taskIndex, int predTaskIndex);
+
+    // Executes all tasks in the current thread arena and waits for them to complete (blocks)
+    void run();
+
+  private:
+    struct Task
+    {
+      std::function<void()> func;
+      std::vector<int> succs; // indices of the tasks depending on this one
+      int numPreds = 0;       // number of tasks this one depends on
+    };
+
+    std::vector<Task> tasks;
+  };
+
+OIDN_NAMESPACE_END
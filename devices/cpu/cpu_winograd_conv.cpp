@@ -0,0 +1,126 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "cpu_winograd_conv.h"
+#include "cpu_winograd_conv_ispc.h"
+
+OIDN_NAMESPACE_BEGIN
+
+  namespace
+  {
+    constexpr int winogradTileSize = 4;   // output tile size
+    constexpr int winogradNumElems = 36;  // number of elements in a transformed tile
+  }
+
+  bool CPUWinogradConv::isApplicable(const ConvDesc& desc)
+  {
+    return desc.srcDesc.dataType == DataType::Float32 &&
+           desc.postOp == PostOp::None &&
+           desc.weightDesc.getH() == 3 && desc.weightDesc.getW() == 3 &&
+           desc.biasDesc.getRank() == 1 &&
+           desc.srcDesc.getH() >= minSize && desc.srcDesc.getW() >= minSize;
+  }
+
+  CPUWinogradConv::CPUWinogradConv(CPUEngine* engine, const ConvDesc& desc)
+    : Conv(desc),
+      engine(engine)
+  {
+    if ((srcDesc.layout != TensorLayout::Chw8c &&
+         srcDesc.layout != TensorLayout::Chw16c) || srcDesc.dataType != DataType::Float32)
+      throw std::invalid_argument("unsupported convolution source layout/data type");
+    if (weightDesc.getW() != 3 || weightDesc.getH() != 3)
+      throw std::invalid_argument("unsupported convolution kernel size");
+    if ((weightDesc.layout != TensorLayout::IOhw8i8o &&
+         weightDesc.layout != TensorLayout::IOhw16i16o) || weightDesc.dataType != DataType::Float32)
+      throw std::invalid_argument("unsupported convolution weight layout/data type");
+    if (biasDesc.getRank() != 1 ||
+        biasDesc.layout != TensorLayout::x || biasDesc.dataType != DataType::Float32)
+      throw std::invalid_argument("unsupported convolution bias layout/data type");
+    if (postOp != PostOp::None)
+      throw std::invalid_argument("unsupported convolution postop");
+
+    const int blockC = getTensorLayoutInfo(dstDesc.layout).blockC;
+    const int IC = srcDesc.getPaddedC();
+
+    blockTW = ispc::CPUWinogradConvKernel_getBlockTW();
+    TH  = ceil_div(dstDesc.getH(), winogradTileSize);
+    TWB = ceil_div(ceil_div(dstDesc.getW(), winogradTileSize), blockTW);
+
+    // Each thread needs space for the transformed input tiles and the products of a tile block
+    threadScratchByteSize = round_up(size_t(winogradNumElems) * blockTW * (IC + blockC) * sizeof(float),
+                                     memoryAlignment);
+  }
+
+  size_t CPUWinogradConv::getScratchByteSize() const
+  {
+    return threadScratchByteSize * engine->getNumThreads();
+  }
+
+  void CPUWinogradConv::setScratch(const Ref<Buffer>& scratch)
+  {
+    if (scratch && scratch->getByteSize() < getScratchByteSize())
+      throw std::invalid_argument("convolution scratch buffer too small");
+    this->scratch = scratch;
+  }
+
+  TensorDesc CPUWinogradConv::getPackedWeightDesc() const
+  {
+    const int numElems = weightDesc.getPaddedO() * weightDesc.getPaddedI() * winogradNumElems;
+    return {{numElems}, TensorLayout::x, DataType::Float32};
+  }
+
+  // Transforms the weights only once, instead of at every execution
+  void CPUWinogradConv::packWeight(Tensor& packedWeight) const
+  {
+    if (!weight)
+      throw std::logic_error("convolution weight not set");
+    if (packedWeight.getDesc() != getPackedWeightDesc())
+      throw std::invalid_argument("invalid convolution packed weight");
+
+    const int blockC = getTensorLayoutInfo(weightDesc.layout).blockC;
+    const int OCB = weightDesc.getPaddedO() / blockC;
+
+    ispc::TensorAccessor4D weightAcc = *weight;
+    float* transformedWeightPtr = static_cast<float*>(packedWeight.getPtr());
+
+    parallel_nd(OCB, [&](int ocb)
+    {
+      ispc::CPUWinogradConvKernel_transformWeight(weightAcc, transformedWeightPtr, ocb * blockC);
+    });
+  }
+
+  void CPUWinogradConv::submit()
+  {
+    if (!src || !dst)
+      throw std::logic_error("convolution source/destination not set");
+    if (!weight || !bias)
+      throw std::logic_error("convolution weight/bias not set");
+    if (!scratch)
+      throw std::logic_error("convolution scratch not set");
+
+    ispc::CPUWinogradConvKernel kernel;
+    kernel.src    = *src;
+    kernel.weight = static_cast<const float*>(getPackedWeight()->getPtr());
+    kernel.bias   = *bias;
+    kernel.dst    = *dst;
+    kernel.relu   = activation == Activation::ReLU;
+
+    char* scratchPtr = static_cast<char*>(scratch->getPtr());
+    const int numThreads = engine->getNumThreads();
+
+    engine->submitHostFunc([=]()
+    {
+      parallel_nd(TH, TWB, [&](int th, int twb)
+      {
+        // Each thread has its own part of the scratch for the transformed tiles
+        const int threadIndex = tbb::this_task_arena::current_thread_index();
+        if (threadIndex < 0 || threadIndex >= numThreads)
+          throw std::logic_error("invalid thread index for convolution scratch");
+
+        float* threadScratchPtr = reinterpret_cast<float*>(scratchPtr + threadIndex * threadScratchByteSize);
+        ispc::CPUWinogradConvKernel_run(&kernel, threadScratchPtr, th, twb * blockTW);
+      });
+    });
+  }
+
+OIDN_NAMESPACE_END
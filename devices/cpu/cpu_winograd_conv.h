@@ -0,0 +1,43 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "core/conv.h"
+#include "cpu_engine.h"
+
+OIDN_NAMESPACE_BEGIN
+
+  // Winograd F(4x4, 3x3) convolution, which requires fewer multiplications than direct convolution
+  // but is slightly less accurate, thus it should be used only when fast math is enabled
+  class CPUWinogradConv final : public Conv
+  {
+  public:
+    // Checks whether the convolution can be computed with Winograd efficiently
+    static bool isApplicable(const ConvDesc& desc);
+
+    CPUWinogradConv(CPUEngine* engine, const ConvDesc& desc);
+
+    size_t getScratchByteSize() const override;
+    void setScratch(const Ref<Buffer>& scratch) override;
+
+    // The packed weight contains the transformed weights
+    TensorDesc getPackedWeightDesc() const override;
+    std::string getPackedWeightSuffix() const override { return ".winograd_weight"; }
+    void packWeight(Tensor& packedWeight) const override;
+
+    void submit() override;
+
+  private:
+    // Minimum spatial size for which Winograd is faster than direct convolution
+    static constexpr int minSize = 16;
+
+    CPUEngine* engine;
+    int blockTW;                  // block of output tiles along the width
+    int TH;                       // number of output tiles along the height
+    int TWB;                      // number of output tile blocks along the width
+    size_t threadScratchByteSize; // scratch size per thread
+    Ref<Buffer> scratch;
+  };
+
+OIDN_NAMESPACE_END
@@ -81,7 +81,9 @@ OIDN_NAMESPACE_BEGIN
     if (!src || !dst || !weight || !bias)
       throw std::logic_error("convolution source/weight/bias/destination not set");
 
-    prim.execute(engine->getDNNLStream(), args);
+    // The arguments are copied because they may change before the queued primitive is executed
+    auto args = this->args;
+    engine->submitHostFunc([this, args]() { prim.execute(engine->getDNNLStream(), args); });
   }
 
 OIDN_NAMESPACE_END
\ No newline at end of file
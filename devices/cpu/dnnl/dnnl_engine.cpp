@@ -7,8 +7,8 @@
 
 OIDN_NAMESPACE_BEGIN
 
-  DNNLEngine::DNNLEngine(CPUDevice* device)
-    : CPUEngine(device)
+  DNNLEngine::DNNLEngine(CPUDevice* device, int arenaIndex)
+    : CPUEngine(device, arenaIndex)
   {
     dnnl_set_verbose(clamp(device->verbose - 2, 0, 2)); // unfortunately this is not per-device but global
     dnnlEngine = dnnl::engine(dnnl::engine::kind::cpu, 0);
@@ -17,6 +17,7 @@ OIDN_NAMESPACE_BEGIN
 
   void DNNLEngine::wait()
   {
+    CPUEngine::wait();
     dnnlStream.wait();
   }
 
@@ -11,7 +11,7 @@ OIDN_NAMESPACE_BEGIN
   class DNNLEngine final : public CPUEngine
   {
   public:
-    explicit DNNLEngine(CPUDevice* device);
+    explicit DNNLEngine(CPUDevice* device, int arenaIndex = 0);
 
     oidn_inline dnnl::engine& getDNNLEngine() { return dnnlEngine; }
     oidn_inline dnnl::stream& getDNNLStream() { return dnnlStream; }
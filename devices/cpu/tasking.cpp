@@ -41,4 +41,26 @@ OIDN_NAMESPACE_BEGIN
       affinity->restore(threadIndex);
   }
 
+  // -----------------------------------------------------------------------------------------------
+  // ParallelFor
+  // -----------------------------------------------------------------------------------------------
+
+  thread_local const ParallelFor* ParallelFor::current = nullptr;
+
+  void ParallelFor::execute(const std::function<void()>& f) const
+  {
+    const ParallelFor* prev = current;
+    current = this;
+    try
+    {
+      f();
+    }
+    catch (...)
+    {
+      current = prev;
+      throw;
+    }
+    current = prev;
+  }
+
 OIDN_NAMESPACE_END
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include "common/common.h"
 #include "core/thread.h"
 
 #if defined(__clang__) && !defined(_LIBCPP_VERSION) && !defined(TBB_USE_GLIBCXX_VERSION)
@@ -32,8 +33,13 @@
 #include "tbb/task_arena.h"
 #include "tbb/parallel_for.h"
 #include "tbb/parallel_reduce.h"
+#include "tbb/parallel_invoke.h"
+#include "tbb/task_group.h"
 #include "tbb/blocked_range.h"
 #include "tbb/blocked_range2d.h"
+#include <functional>
+#include <mutex>
+#include <exception>
 
 OIDN_NAMESPACE_BEGIN
 
@@ -55,6 +61,67 @@ OIDN_NAMESPACE_BEGIN
     std::shared_ptr<ThreadAffinity> affinity;
   };
 
+  // -----------------------------------------------------------------------------------------------
+  // ParallelFor
+  // -----------------------------------------------------------------------------------------------
+
+  // Parallel for function provided by the application (e.g. using its own task scheduler), which is
+  // used by parallel_nd instead of TBB in the threads executing the work of the device
+  class ParallelFor
+  {
+  public:
+    ParallelFor(ParallelForFunction func, void* userPtr)
+      : func(func), userPtr(userPtr) {}
+
+    // Calls f(i) for all i in [0, n) using the parallel for function, and rethrows the first
+    // exception thrown by f, if any
+    template<typename F>
+    void run(size_t n, const F& f) const
+    {
+      struct Task
+      {
+        const F& f;
+        std::exception_ptr error;
+        std::mutex mutex;
+
+        explicit Task(const F& f) : f(f) {}
+      };
+
+      Task task(f);
+      func(userPtr, n, [](void* taskPtr, size_t begin, size_t end)
+      {
+        Task& task = *static_cast<Task*>(taskPtr);
+        try
+        {
+          for (size_t i = begin; i < end; ++i)
+            task.f(i);
+        }
+        catch (...)
+        {
+          // Exceptions cannot propagate through the function of the application
+          std::lock_guard<std::mutex> lock(task.mutex);
+          if (!task.error)
+            task.error = std::current_exception();
+        }
+      }, &task);
+
+      if (task.error)
+        std::rethrow_exception(task.error);
+    }
+
+    // Executes a function in the current thread, in which parallel_nd uses this parallel for function
+    void execute(const std::function<void()>& f) const;
+
+    // Returns the parallel for function used by parallel_nd in the current thread (null for TBB)
+    static const ParallelFor* getCurrent() { return current; }
+
+  private:
+    ParallelForFunction func;
+    void* userPtr;
+
+    static thread_local const ParallelFor* current;
+  };
+
   // -----------------------------------------------------------------------------------------------
   // parallel_nd
   // -----------------------------------------------------------------------------------------------
@@ -62,6 +129,12 @@ OIDN_NAMESPACE_BEGIN
   template<typename T0, typename F>
   oidn_inline void parallel_nd(const T0& D0, const F& f)
   {
+    if (const ParallelFor* parallelFor = ParallelFor::getCurrent())
+    {
+      parallelFor->run(size_t(D0), [&](size_t i) { f(T0(i)); });
+      return;
+    }
+
     tbb::parallel_for(tbb::blocked_range<T0>(0, D0), [&](const tbb::blocked_range<T0>& r)
     {
       for (T0 i = r.begin(); i != r.end(); ++i)
@@ -72,6 +145,12 @@ OIDN_NAMESPACE_BEGIN
   template<typename T0, typename T1, typename F>
   oidn_inline void parallel_nd(const T0& D0, const T1& D1, const F& f)
   {
+    if (const ParallelFor* parallelFor = ParallelFor::getCurrent())
+    {
+      parallelFor->run(size_t(D0) * size_t(D1), [&](size_t i) { f(T0(i / size_t(D1)), T1(i % size_t(D1))); });
+      return;
+    }
+
     tbb::parallel_for(tbb::blocked_range2d<T0, T1>(0, D0, 0, D1), [&](const tbb::blocked_range2d<T0, T1>& r)
     {
       for (T0 i = r.rows().begin(); i != r.rows().end(); ++i)
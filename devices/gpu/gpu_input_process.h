@@ -33,6 +33,7 @@ OIDN_NAMESPACE_BEGIN
     TransferFunction transferFunc;
     bool hdr;
     bool snorm; // signed normalized ([-1..1])
+    bool keepAux; // keep the auxiliary features already stored in the destination
 
     oidn_device_inline vec3f getInput(int h, int w) const
     {
@@ -84,15 +85,22 @@ OIDN_NAMESPACE_BEGIN
       const int hDst = it.getGlobalID<0>();
       const int wDst = it.getGlobalID<1>();
 
-      const int h = hDst - tile.hDstBegin;
+      // Get the image in the tile and its row
+      int h = hDst - tile.hDstBegin;
+      int b = 0;
+      if (tile.B > 1 && h >= 0)
+      {
+        b = h / tile.hDstStride;
+        h -= b * tile.hDstStride;
+      }
       const int w = wDst - tile.wDstBegin;
 
       // Gather and process the input channel values
       float values[dstPaddedC] = {}; // = 0
 
-      if (h >= 0 && h < tile.H && w >= 0 && w < tile.W)
+      if (h >= 0 && h < tile.H && b < tile.B && w >= 0 && w < tile.W)
       {
-        const int hSrc = h + tile.hSrcBegin;
+        const int hSrc = h + tile.hSrcBegin + b * tile.hSrcStride;
         const int wSrc = w + tile.wSrcBegin;
 
         const vec3f inputValue = getInput(hSrc, wSrc);
@@ -100,7 +108,14 @@ OIDN_NAMESPACE_BEGIN
         values[1] = inputValue.y;
         values[2] = inputValue.z;
 
-        if (dstPaddedC >= 6 && albedo.ptr)
+        if (keepAux)
+        {
+          // Load the previously processed auxiliary features to store them again
+          #pragma unroll
+          for (int c = 3; c < min(dstPaddedC, 9); ++c)
+            values[c] = dst(c, hDst, wDst);
+        }
+        else if (dstPaddedC >= 6 && albedo.ptr)
         {
           const vec3f albedoValue = getAlbedo(hSrc, wSrc);
           values[3] = albedoValue.x;
@@ -247,6 +262,7 @@ OIDN_NAMESPACE_BEGIN
       kernel.transferFunc = *transferFunc;
       kernel.hdr   = hdr;
       kernel.snorm = snorm;
+      kernel.keepAux = keepAux;
 
       const WorkDim<2> numGroups{dst->getH(), ceil_div(dst->getW(), subgroupSize)};
       const WorkDim<2> groupSize{1, subgroupSize};
@@ -34,11 +34,14 @@ OIDN_NAMESPACE_BEGIN
 
     oidn_device_inline void operator ()(const oidn_private WorkItem<2>& it) const
     {
-      const int h = it.getGlobalID<0>();
+      const int hTile = it.getGlobalID<0>();
       const int w = it.getGlobalID<1>();
 
-      const int hSrc = h + tile.hSrcBegin;
-      const int hDst = h + tile.hDstBegin;
+      // Get the image in the tile and its row
+      const int b = hTile / tile.H;
+      const int h = hTile - b * tile.H;
+      const int hSrc = h + tile.hSrcBegin + b * tile.hSrcStride;
+      const int hDst = h + tile.hDstBegin + b * tile.hDstStride;
       const int wSrc = w + tile.wSrcBegin;
       const int wDst = w + tile.wDstBegin;
 
@@ -110,10 +113,10 @@ OIDN_NAMESPACE_BEGIN
       kernel.snorm = snorm;
 
     #if defined(OIDN_COMPILE_METAL)
-      engine->submitKernel(WorkDim<2>(tile.H, tile.W), kernel,
+      engine->submitKernel(WorkDim<2>(tile.B * tile.H, tile.W), kernel,
                            pipeline, {src->getBuffer(), dst->getBuffer(), scratch});
     #else
-      engine->submitKernel(WorkDim<2>(tile.H, tile.W), kernel);
+      engine->submitKernel(WorkDim<2>(tile.B * tile.H, tile.W), kernel);
     #endif
     }
 
@@ -97,6 +97,14 @@ typedef enum
 // Error callback function
 typedef void (*OIDNErrorFunction)(void* userPtr, OIDNError code, const char* message);
 
+// Task function of a parallel for loop, which processes the range of indices [begin, end)
+typedef void (*OIDNParallelForTask)(void* taskPtr, size_t begin, size_t end);
+
+// Parallel for loop callback function, which must call the task for disjoint ranges covering the
+// indices [0, n), possibly in parallel, and return only after all calls have completed
+typedef void (*OIDNParallelForFunction)(void* userPtr, size_t n, OIDNParallelForTask task,
+                                        void* taskPtr);
+
 // Device handle
 typedef struct OIDNDeviceImpl* OIDNDevice;
 
@@ -139,6 +147,11 @@ OIDN_API OIDNDevice oidnNewHIPDevice(const int* deviceIDs, const hipStream_t* st
 // Currently only one queue is supported.
 OIDN_API OIDNDevice oidnNewMetalDevice(const MTLCommandQueue_id* commandQueues, int numQueues);
 
+// Creates a CPU device which executes its parallel work with the specified parallel for function
+// (e.g. using the task scheduler of the application) instead of creating its own worker threads.
+// The function may be called from any thread.
+OIDN_API OIDNDevice oidnNewCPUDevice(OIDNParallelForFunction func, void* userPtr);
+
 // Retains the device (increments the reference count).
 OIDN_API void oidnRetainDevice(OIDNDevice device);
 
@@ -193,6 +206,12 @@ inline int oidnGetDevice1i(OIDNDevice device, const char* name)
   return oidnGetDeviceInt(device, name);
 }
 
+// Sets a string parameter of the device.
+OIDN_API void oidnSetDeviceString(OIDNDevice device, const char* name, const char* value);
+
+// Gets a string parameter of the device.
+OIDN_API const char* oidnGetDeviceString(OIDNDevice device, const char* name);
+
 // Sets the error callback function of the device.
 OIDN_API void oidnSetDeviceErrorFunction(OIDNDevice device, OIDNErrorFunction func, void* userPtr);
 
@@ -355,7 +374,7 @@ typedef enum
 {
   OIDN_QUALITY_DEFAULT  = 0, // default quality
 
-//OIDN_QUALITY_FAST     = 4
+  OIDN_QUALITY_FAST     = 4, // high performance (for interactive/real-time preview rendering)
   OIDN_QUALITY_BALANCED = 5, // balanced quality/performance (for interactive/real-time rendering)
   OIDN_QUALITY_HIGH     = 6, // high quality (for final-frame rendering)
 } OIDNQuality;
@@ -416,6 +435,11 @@ inline void oidnRemoveFilterData(OIDNFilter filter, const char* name)
   oidnUnsetFilterData(filter, name);
 }
 
+// Gets an opaque data parameter of the filter, optionally also returning its size in bytes (if not
+// NULL). The returned pointer is valid until the next call to this function or until the filter is
+// executed or released.
+OIDN_API const void* oidnGetFilterData(OIDNFilter filter, const char* name, size_t* byteSize);
+
 // Sets a boolean parameter of the filter.
 OIDN_API void oidnSetFilterBool(OIDNFilter filter, const char* name, bool value);
 
@@ -470,6 +494,12 @@ inline float oidnGetFilter1f(OIDNFilter filter, const char* name)
   return oidnGetFilterFloat(filter, name);
 }
 
+// Sets a string parameter of the filter.
+OIDN_API void oidnSetFilterString(OIDNFilter filter, const char* name, const char* value);
+
+// Gets a string parameter of the filter.
+OIDN_API const char* oidnGetFilterString(OIDNFilter filter, const char* name);
+
 // Sets the progress monitor callback function of the filter.
 OIDN_API void oidnSetFilterProgressMonitorFunction(OIDNFilter filter,
                                                    OIDNProgressMonitorFunction func, void* userPtr);
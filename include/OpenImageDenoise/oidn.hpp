@@ -323,6 +323,7 @@ OIDN_NAMESPACE_BEGIN
   {
     Default  = OIDN_QUALITY_DEFAULT,  // default quality
 
+    Fast     = OIDN_QUALITY_FAST,     // high performance (for interactive/real-time preview rendering)
     Balanced = OIDN_QUALITY_BALANCED, // balanced quality/performance (for interactive/real-time rendering)
     High     = OIDN_QUALITY_HIGH,     // high quality (for final-frame rendering)
   };
@@ -467,6 +468,16 @@ OIDN_NAMESPACE_BEGIN
       oidnUnsetFilterData(handle, name);
     }
 
+    // Gets an opaque data parameter of the filter, returning a pointer to the data and its size in
+    // bytes. The pointer is valid until the next call to this function or until the filter is
+    // executed or released.
+    std::pair<const void*, size_t> getData(const char* name) const
+    {
+      size_t byteSize = 0;
+      const void* ptr = oidnGetFilterData(handle, name, &byteSize);
+      return {ptr, byteSize};
+    }
+
     // Sets a boolean parameter of the filter.
     void set(const char* name, bool value)
     {
@@ -490,6 +501,18 @@ OIDN_NAMESPACE_BEGIN
       oidnSetFilterFloat(handle, name, value);
     }
 
+    // Sets a string parameter of the filter.
+    void set(const char* name, const char* value)
+    {
+      oidnSetFilterString(handle, name, value);
+    }
+
+    // Sets a string parameter of the filter.
+    void set(const char* name, const std::string& value)
+    {
+      oidnSetFilterString(handle, name, value.c_str());
+    }
+
     // Gets a parameter of the filter.
     template<typename T>
     T get(const char* name) const;
@@ -557,6 +580,19 @@ OIDN_NAMESPACE_BEGIN
     return oidnGetFilterFloat(handle, name);
   }
 
+  template<>
+  inline const char* FilterRef::get(const char* name) const
+  {
+    return oidnGetFilterString(handle, name);
+  }
+
+  template<>
+  inline std::string FilterRef::get(const char* name) const
+  {
+    const char* str = oidnGetFilterString(handle, name);
+    return str ? str : "";
+  }
+
   // -----------------------------------------------------------------------------------------------
   // Device
   // -----------------------------------------------------------------------------------------------
@@ -588,6 +624,10 @@ OIDN_NAMESPACE_BEGIN
   // Error callback function
   typedef void (*ErrorFunction)(void* userPtr, Error code, const char* message);
 
+  // Parallel for loop task and callback functions
+  using ParallelForTask     = OIDNParallelForTask;
+  using ParallelForFunction = OIDNParallelForFunction;
+
   // Opaque universally unique identifier (UUID) of a physical device
   struct UUID
   {
@@ -699,6 +739,18 @@ OIDN_NAMESPACE_BEGIN
       oidnSetDeviceUInt(handle, name, value);
     }
 
+    // Sets a string parameter of the device.
+    void set(const char* name, const char* value)
+    {
+      oidnSetDeviceString(handle, name, value);
+    }
+
+    // Sets a string parameter of the device.
+    void set(const char* name, const std::string& value)
+    {
+      oidnSetDeviceString(handle, name, value.c_str());
+    }
+
     // Gets a parameter of the device.
     template<typename T>
     T get(const char* name) const;
@@ -819,6 +871,19 @@ OIDN_NAMESPACE_BEGIN
     return ExternalMemoryTypeFlags(oidnGetDeviceInt(handle, name));
   }
 
+  template<>
+  inline const char* DeviceRef::get(const char* name) const
+  {
+    return oidnGetDeviceString(handle, name);
+  }
+
+  template<>
+  inline std::string DeviceRef::get(const char* name) const
+  {
+    const char* str = oidnGetDeviceString(handle, name);
+    return str ? str : "";
+  }
+
   // Returns the first unqueried per-thread global error code and clears the stored error.
   inline Error getError()
   {
@@ -927,6 +992,14 @@ OIDN_NAMESPACE_BEGIN
     return DeviceRef(oidnNewMetalDevice(commandQueues.data(), static_cast<int>(commandQueues.size())));
   }
 
+  // Creates a CPU device which executes its parallel work with the specified parallel for function
+  // (e.g. using the task scheduler of the application) instead of creating its own worker threads.
+  // The function may be called from any thread.
+  inline DeviceRef newCPUDevice(ParallelForFunction func, void* userPtr = nullptr)
+  {
+    return DeviceRef(oidnNewCPUDevice(func, userPtr));
+  }
+
   // -----------------------------------------------------------------------------------------------
   // Physical Device
   // -----------------------------------------------------------------------------------------------
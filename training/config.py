@@ -123,7 +123,7 @@ def parse_args(cmd=None, description=None):
                         help='number of data loader threads per device')
     parser.add_argument('--precision', '-p', type=str, choices=['fp32', 'mixed'],
                         help='training precision')
-    advanced.add_argument('--model', '-m', type=str, choices=['unet'], default='unet',
+    advanced.add_argument('--model', '-m', type=str, choices=['unet', 'unet_small'], default='unet',
                           help='network model')
     advanced.add_argument('--loss', '-l', type=str,
                           choices=['l1', 'mape', 'smape', 'l2', 'ssim', 'msssim', 'l1_msssim', 'l1_grad'],
@@ -159,6 +159,10 @@ def parse_args(cmd=None, description=None):
                         help='what to export')
     parser.add_argument('--output', '-o', type=str,
                         help='output file')
+    parser.add_argument('--calibrate', action='store_true',
+                        help='calibrate and export the activation scales for INT8 inference')
+    parser.add_argument('--calib_data', type=str,
+                        help='name of the preprocessed dataset used for calibration (default: validation dataset of the result)')
 
   if cmd in {'convert_image', 'split_exr'}:
     parser.add_argument('input', type=str,
@@ -7,10 +7,14 @@ import os
 from glob import glob
 import numpy as np
 import torch
+import torch.nn as nn
+from torch.utils.data import DataLoader
 
 from config import *
 from util import *
 from result import *
+from model import *
+from dataset import *
 import tza
 
 def main():
@@ -66,6 +70,56 @@ def export_weights(cfg):
 
       output_file.write(name, tensor, layout)
 
+    # Save the network topology, which is used by the runtime to build the network
+    model = get_model(result_cfg)
+    output_file.write_metadata('topology', get_topology(model))
+
+    # Save the quantization scales of the convolution inputs, which enable INT8 inference
+    if cfg.calibrate:
+      model.to(device)
+      model.load_state_dict(model_state)
+      for name, scale in calibrate(cfg, result_cfg, device, model).items():
+        print(name + '.input_scale', scale)
+        output_file.write(name + '.input_scale', np.array([scale], dtype=np.float32), 'x')
+
+# Returns the quantization scales of the convolution inputs (unsigned 8-bit) computed from the
+# maximum values over a calibration dataset
+# Inputs which may be negative cannot be quantized, thus these are omitted
+def calibrate(cfg, result_cfg, device, model):
+  data_name = cfg.calib_data if cfg.calib_data else result_cfg.valid_data
+  data = ValidationDataset(result_cfg, data_name)
+  if len(data) == 0:
+    error('no calibration images')
+  print('Calibration images:', data.num_images)
+  loader = DataLoader(data, batch_size=result_cfg.batch_size)
+
+  # Record the range of the inputs of all convolutions
+  ranges = {}
+
+  def get_hook(name):
+    def hook(module, input):
+      x = input[0].detach()
+      min_value, max_value = x.min().item(), x.max().item()
+      if name in ranges:
+        min_value = min(min_value, ranges[name][0])
+        max_value = max(max_value, ranges[name][1])
+      ranges[name] = (min_value, max_value)
+    return hook
+
+  hooks = [module.register_forward_pre_hook(get_hook(name))
+           for name, module in model.named_modules() if isinstance(module, nn.Conv2d)]
+
+  model.eval()
+  with torch.no_grad():
+    for input, _ in loader:
+      model(input.to(device).float())
+
+  for hook in hooks:
+    hook.remove()
+
+  return {name: max_value / 255. for name, (min_value, max_value) in ranges.items()
+          if min_value >= 0. and max_value > 0.}
+
 # Exports the result directory to a ZIP file
 def export_package(cfg):
   # Get the output filename
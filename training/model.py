@@ -14,9 +14,19 @@ def get_model(cfg):
   num_input_channels = len(get_model_channels(cfg.features))
   if type == 'unet':
     return UNet(num_input_channels)
+  elif type == 'unet_small':
+    return UNet(num_input_channels, small=True)
   else:
     error('invalid model')
 
+# Returns the topology of a model in the format stored in the exported weights, which
+# contains a line for each convolution in execution order:
+# <name> <source> <skip or -> <activation or -> <post-op or ->
+# The skip connection is concatenated to the source, and the post-op is either 'pool'
+# (2x2 max pool) or 'upsample' (2x2 nearest-neighbor upsample)
+def get_topology(model):
+  return ''.join(' '.join(layer) + '\n' for layer in model.topology)
+
 ## -----------------------------------------------------------------------------
 ## Network layers
 ## -----------------------------------------------------------------------------
@@ -46,21 +56,35 @@ def concat(a, b):
 ## -----------------------------------------------------------------------------
 
 class UNet(nn.Module):
-  def __init__(self, in_channels=3, out_channels=3):
+  # The small variant has half as many channels per layer, thus it has about 4x lower
+  # computational cost (used for the fast quality mode of the runtime)
+  def __init__(self, in_channels=3, out_channels=3, small=False):
     super(UNet, self).__init__()
 
     # Number of channels per layer
     ic   = in_channels
-    ec1  = 32
-    ec2  = 48
-    ec3  = 64
-    ec4  = 80
-    ec5  = 96
-    dc4  = 112
-    dc3  = 96
-    dc2  = 64
-    dc1a = 64
-    dc1b = 32
+    if small:
+      ec1  = 16
+      ec2  = 24
+      ec3  = 32
+      ec4  = 40
+      ec5  = 48
+      dc4  = 56
+      dc3  = 48
+      dc2  = 32
+      dc1a = 32
+      dc1b = 16
+    else:
+      ec1  = 32
+      ec2  = 48
+      ec3  = 64
+      ec4  = 80
+      ec5  = 96
+      dc4  = 112
+      dc3  = 96
+      dc2  = 64
+      dc1a = 64
+      dc1b = 32
     oc   = out_channels
 
     # Convolutions
@@ -84,6 +108,28 @@ class UNet(nn.Module):
     # Images must be padded to multiples of the alignment
     self.alignment = 16
 
+    # Topology of the network for the runtime (see get_topology)
+    # The runtime applies ReLU to the output as well, which is non-negative anyway
+    self.topology = [
+      # name        source        skip         activation  post-op
+      ('enc_conv0',  'input',      '-',         'relu',     '-'),
+      ('enc_conv1',  'enc_conv0',  '-',         'relu',     'pool'),
+      ('enc_conv2',  'enc_conv1',  '-',         'relu',     'pool'),
+      ('enc_conv3',  'enc_conv2',  '-',         'relu',     'pool'),
+      ('enc_conv4',  'enc_conv3',  '-',         'relu',     'pool'),
+      ('enc_conv5a', 'enc_conv4',  '-',         'relu',     '-'),
+      ('enc_conv5b', 'enc_conv5a', '-',         'relu',     'upsample'),
+      ('dec_conv4a', 'enc_conv5b', 'enc_conv3', 'relu',     '-'),
+      ('dec_conv4b', 'dec_conv4a', '-',         'relu',     'upsample'),
+      ('dec_conv3a', 'dec_conv4b', 'enc_conv2', 'relu',     '-'),
+      ('dec_conv3b', 'dec_conv3a', '-',         'relu',     'upsample'),
+      ('dec_conv2a', 'dec_conv3b', 'enc_conv1', 'relu',     '-'),
+      ('dec_conv2b', 'dec_conv2a', '-',         'relu',     'upsample'),
+      ('dec_conv1a', 'dec_conv2b', 'input',     'relu',     '-'),
+      ('dec_conv1b', 'dec_conv1a', '-',         'relu',     '-'),
+      ('dec_conv0',  'dec_conv1b', '-',         'relu',     '-'),
+    ]
+
   def forward(self, input):
     # Encoder
     # -------------------------------------------
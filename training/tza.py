@@ -5,7 +5,7 @@ import struct
 import numpy as np
 
 # Tensor Archive (TZA) file format
-VERSION = (2, 0)
+VERSION = (2, 1)
 _MAGIC = 0x41D7
 
 # Writes tensors to a TZA file
@@ -13,6 +13,7 @@ class Writer(object):
   # Creates a new file
   def __init__(self, filename):
     self._table = []
+    self._metadata = {}
     self._file = open(filename, 'wb')
     self._write_header()
 
@@ -57,6 +58,12 @@ class Writer(object):
     self._write_uint16(len(data))
     self._file.write(data)
 
+  # Writes a long UTF-8 string to the file
+  def _write_long_str(self, str):
+    data = str.encode()
+    self._write_uint32(len(data))
+    self._file.write(data)
+
   # Writes padding to the file
   def _write_pad(self, alignment=64):
     offset = self._file.tell()
@@ -87,6 +94,12 @@ class Writer(object):
       self._write_raw_str(dtype)
       self._write_uint64(offset)
 
+    # The metadata follows the tensors (since version 2.1)
+    self._write_uint32(len(self._metadata))
+    for key, value in self._metadata.items():
+      self._write_str(key)
+      self._write_long_str(value)
+
     self._file.seek(4) # skip magic and version
     self._write_uint64(table_offset)
 
@@ -103,6 +116,10 @@ class Writer(object):
     self._table.append((name, shape, layout, dtype, offset))
     tensor.tofile(self._file)
 
+  # Writes a metadata string (e.g. the network topology)
+  def write_metadata(self, key, value):
+    self._metadata[key] = value
+
   # Closes the file
   def close(self):
     self._write_table()
@@ -131,6 +148,10 @@ class Reader(object):
   def __len__(self):
     return len(self._table)
 
+  # Returns the metadata string with the specified key, or None if not found
+  def get_metadata(self, key):
+    return self._metadata.get(key)
+
   # Returns a (tensor, layout) tuple given the name of a tensor
   def __getitem__(self, name):
     # Lazily map the entire file into memory
@@ -186,6 +207,12 @@ class Reader(object):
     data = self._file.read(n)
     return data.decode()
 
+  # Reads a long UTF-8 string from the file
+  def _read_long_str(self):
+    n = self._read_uint32()
+    data = self._file.read(n)
+    return data.decode()
+
   # Reads the header from the file
   def _read_header(self):
     magic = self._read_uint16()
@@ -211,3 +238,10 @@ class Reader(object):
       offset = self._read_uint64()
 
       self._table[name] = (shape, layout, dtype, offset)
+
+    self._metadata = {}
+    if self._version[1] >= 1:
+      num_entries = self._read_uint32()
+      for _ in range(num_entries):
+        key = self._read_str()
+        self._metadata[key] = self._read_long_str()